@@ -1,6 +1,7 @@
 #include "ConsoleManager.h"
 #include "Instruction.h"
 #include "InstructionsTypes.h"
+#include "ProgramLoader.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -8,6 +9,16 @@
 #include <chrono>
 #include <cstdlib>
 #include <random>
+#include <filesystem>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
 
 
 const int cpuCycleTicks = 100; //constant ticks ng CPU
@@ -48,11 +59,16 @@ void Option1() {
 
 void Option2() {
     std::cout << "\nOptions:" << std::endl;
-    std::cout << "- screen -ls" << std::endl;
-    std::cout << "- screen -s [process name]" << std::endl;
+    std::cout << "- screen -ls [--state=..] [--core=N] [--name=prefix] [--sort=pid|name|progress] [--top N]" << std::endl;
+    std::cout << "- screen -s [process name] [program file]" << std::endl;
     std::cout << "- screen -r [process name]" << std::endl;
+    std::cout << "- load-dir [directory]" << std::endl;
+    std::cout << "- group-create [group name] [size] [priority] [quantum]" << std::endl;
     std::cout << "- scheduler-start" << std::endl;
     std::cout << "- scheduler-stop" << std::endl;
+    std::cout << "- reconfigure" << std::endl;
+    std::cout << "- trace-start [file]" << std::endl;
+    std::cout << "- trace-stop" << std::endl;
     std::cout << "- report-util" << std::endl;
     std::cout << "- exit" << std::endl;
 }
@@ -67,7 +83,12 @@ void ConsoleManager::run() {
         std::cout << "\nRoot:\\> ";
         std::getline(std::cin, input);
 
-        if (input == "exit") break;
+        if (input == "exit") {
+            if (ticking) stopScheduler();
+            if (scheduler) scheduler->stopTrace();
+            stopConfigWatcher();
+            break;
+        }
 
         if (!isInitialized && input != "initialize") {
             std::cout << "Please initialize the system first using `initialize` command.\n";
@@ -76,18 +97,41 @@ void ConsoleManager::run() {
 
         if (input == "initialize") {
             initialize();
-        } else if (input == "screen -ls") {
-            listScreens();
+        } else if (input == "screen -ls" || input.rfind("screen -ls ", 0) == 0) {
+            listScreens(input.substr(std::min<size_t>(input.size(), 11)));
         } else if (input.rfind("screen -s ", 0) == 0) {
-            std::string name = input.substr(10);
-            screenAttach(name);
+            std::string args = input.substr(10);
+            size_t space = args.find(' ');
+            if (space == std::string::npos) {
+                screenAttach(args);
+            } else {
+                screenAttach(args.substr(0, space), args.substr(space + 1));
+            }
         } else if (input.rfind("screen -r ", 0) == 0) {
             std::string name = input.substr(10);
             screenReattach(name);
+        } else if (input.rfind("load-dir ", 0) == 0) {
+            loadDirectory(input.substr(9));
+        } else if (input.rfind("group-create ", 0) == 0) {
+            std::istringstream args(input.substr(13));
+            std::string name;
+            int size = 0, priority = 0, quantum = 0;
+            if (!(args >> name >> size) || size <= 0) {
+                std::cout << "Usage: group-create <group name> <size> [priority] [quantum]\n";
+            } else {
+                args >> priority >> quantum;
+                createGroup(name, size, priority, quantum);
+            }
         } else if (input == "scheduler-start") {
             startScheduler();
         } else if (input == "scheduler-stop") {
             stopScheduler();
+        } else if (input == "reconfigure") {
+            reconfigure();
+        } else if (input.rfind("trace-start ", 0) == 0) {
+            startTrace(input.substr(12));
+        } else if (input == "trace-stop") {
+            stopTrace();
         } else if (input == "report-util") {
             generateReport();
         } else {
@@ -99,6 +143,7 @@ void ConsoleManager::run() {
 
 void ConsoleManager::initialize() {
     loadConfig();
+    if (!isInitialized) startConfigWatcher();
     isInitialized = true;
     std::cout << "System initialized successfully.\n";
 }
@@ -112,69 +157,251 @@ void ConsoleManager::printConfig() const {
     std::cout << "Delay per Execution: " << delayPerExec << "ms\n"; 
 }
 
-void ConsoleManager::loadConfig() {
+bool ConsoleManager::loadConfig() {
     std::ifstream file("config.txt");
     if (!file.is_open()) {
         std::cout << "Failed to open config.txt. Using defaults.\n";
-        return;
+        return false;
     }
 
+    // parse into locals first, the generator and watcher threads read these while we run
+    int cpus = numCPU, quantum = quantumCycles, freq = batchProcessFreq;
+    int minIns = minInstructions, maxIns = maxInstructions, delay = delayPerExec;
+    int inFlight = maxInFlight, high = readyQueueHigh, low = readyQueueLow;
+    int evict = evictFinished ? 1 : 0;
+    std::string algo = getSchedulerAlgo();
+
     std::string key;
     while (file >> key) {
-        if (key == "num-cpu") file >> numCPU;
-        else if (key == "scheduler") file >> schedulerAlgo;
-        else if (key == "quantum-cycles") file >> quantumCycles;
-        else if (key == "batch-process-freq") file >> batchProcessFreq;
-        else if (key == "min-ins") file >> minInstructions;
-        else if (key == "max-ins") file >> maxInstructions;
-        else if (key == "delay-per-exec") file >> delayPerExec;
+        if (key == "num-cpu") file >> cpus;
+        else if (key == "scheduler") file >> algo;
+        else if (key == "quantum-cycles") file >> quantum;
+        else if (key == "batch-process-freq") file >> freq;
+        else if (key == "min-ins") file >> minIns;
+        else if (key == "max-ins") file >> maxIns;
+        else if (key == "delay-per-exec") file >> delay;
+        else if (key == "max-in-flight") file >> inFlight;
+        else if (key == "ready-queue-high") file >> high;
+        else if (key == "ready-queue-low") file >> low;
+        else if (key == "evict-finished") file >> evict;
+    }
+
+    if (cpus < 1) cpus = 1;
+    if (quantum < 1) quantum = 1;
+    if (freq < 1) freq = 1;
+    if (minIns < 1) minIns = 1;
+    if (maxIns < minIns) maxIns = minIns;
+    if (inFlight < 0) inFlight = 0;
+    if (high < 0) high = 0;
+    if (low < 0 || low > high) low = high / 2;
+
+    {
+        std::lock_guard<std::mutex> lock(configMutex);
+        numCPU = cpus;
+        schedulerAlgo = algo;
+        quantumCycles = quantum;
+        batchProcessFreq = freq;
+        minInstructions = minIns;
+        maxInstructions = maxIns;
+        delayPerExec = delay;
+        maxInFlight = inFlight;
+        readyQueueHigh = high;
+        readyQueueLow = low;
+        evictFinished = evict != 0;
+    }
+
+    std::cout << "Config loaded: " << cpus << " CPUs, Scheduler = " << algo
+              << ", Quantum = " << quantum << ", Min/Max Instructions = "
+              << minIns << "/" << maxIns << ", Delay = " << delay << "\n";
+    return true;
+}
+
+std::string ConsoleManager::getSchedulerAlgo() const {
+    std::lock_guard<std::mutex> lock(configMutex);
+    return schedulerAlgo;
+}
+
+int ConsoleManager::randomInstructionCount() const {
+    std::lock_guard<std::mutex> lock(configMutex);
+    return minInstructions + (rand() % (maxInstructions - minInstructions + 1));
+}
+
+// reconfigure, also run by the config watcher. Queued and running processes stay where they are.
+void ConsoleManager::reconfigure() {
+    if (!loadConfig()) return;
+
+    std::lock_guard<std::mutex> lock(configMutex);
+    if (!scheduler) return;
+    auto split = scheduler->reconfigure(numCPU, schedulerAlgo, quantumCycles, delayPerExec);
+    std::cout << "Scheduler reconfigured: " << numCPU << " CPUs, " << schedulerAlgo
+              << ", Quantum = " << quantumCycles << "\n";
+    reportSplitGroups(split);
+}
+
+void ConsoleManager::reportSplitGroups(const std::vector<std::shared_ptr<ProcessGroup>>& split) const {
+    for (const auto& group : split) {
+        std::cout << "Group " << group->getName() << " no longer fits in " << numCPU
+                  << " cores, its members are scheduled individually.\n";
+    }
+}
+
+// Reloads config.txt when it changes. POSIX sleeps on inotify until the file is written or
+// replaced, Windows polls its modification time once a second.
+void ConsoleManager::startConfigWatcher() {
+    watchingConfig = true;
+#ifdef _WIN32
+    configWatcherThread = std::thread([this]() {
+        std::error_code ec;
+        auto lastWrite = std::filesystem::last_write_time("config.txt", ec);
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(stopMutex);
+                if (stopSignal.wait_for(lock, std::chrono::seconds(1), [this]() { return !watchingConfig; })) break;
+            }
+
+            auto current = std::filesystem::last_write_time("config.txt", ec);
+            if (ec || current == lastWrite) continue;
+            lastWrite = current;
+
+            std::cout << "\nconfig.txt changed, reloading.\n";
+            reconfigure();
+        }
+    });
+#else
+    int notifyFd = ::inotify_init1(IN_CLOEXEC);
+    // the directory is watched since editors often save by renaming a new file over config.txt
+    if (notifyFd < 0 || ::inotify_add_watch(notifyFd, ".", IN_CLOSE_WRITE | IN_MOVED_TO) < 0
+        || ::pipe(configWatchStop) != 0) {
+        std::cout << "Cannot watch config.txt for changes (" << std::strerror(errno) << "), use reconfigure instead.\n";
+        if (notifyFd >= 0) ::close(notifyFd);
+        watchingConfig = false;
+        return;
     }
 
-    std::cout << "Config loaded: " << numCPU << " CPUs, Scheduler = " << schedulerAlgo
-              << ", Quantum = " << quantumCycles << ", Min/Max Instructions = "
-              << minInstructions << "/" << maxInstructions << ", Delay = " << delayPerExec << "\n";
+    configWatcherThread = std::thread([this, notifyFd]() {
+        alignas(inotify_event) char buffer[4096];
+        pollfd fds[2] = {{notifyFd, POLLIN, 0}, {configWatchStop[0], POLLIN, 0}};
+        while (true) {
+            if (::poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            if (fds[1].revents != 0) break;
+
+            ssize_t length = ::read(notifyFd, buffer, sizeof(buffer));
+            if (length <= 0) continue;
+            bool changed = false;
+            for (char* p = buffer; p < buffer + length; ) {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                if (event->len > 0 && std::strcmp(event->name, "config.txt") == 0) changed = true;
+                p += sizeof(inotify_event) + event->len;
+            }
+            if (!changed) continue;
+
+            std::cout << "\nconfig.txt changed, reloading.\n";
+            reconfigure();
+        }
+        ::close(notifyFd);
+    });
+#endif
+}
+
+void ConsoleManager::stopConfigWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        watchingConfig = false;
+    }
+    stopSignal.notify_all();
+#ifndef _WIN32
+    if (configWatchStop[1] >= 0) {
+        char stop = 1;
+        while (::write(configWatchStop[1], &stop, 1) < 0 && errno == EINTR) {}
+    }
+#endif
+    if (configWatcherThread.joinable()) {
+        configWatcherThread.join();
+    }
+#ifndef _WIN32
+    for (int& fd : configWatchStop) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+#endif
 }
 
 void ConsoleManager::startScheduler() {
+    if (ticking) {
+        std::cout << "Scheduler is already running.\n";
+        return;
+    }
+
     std::cout << "Starting process generation...\n";
 
-    scheduler = std::make_unique<Scheduler>(numCPU, schedulerAlgo, quantumCycles);
+    {
+        std::lock_guard<std::mutex> lock(configMutex);
+        if (!scheduler) {
+            scheduler = std::make_unique<Scheduler>(numCPU, schedulerAlgo, quantumCycles, delayPerExec);
+            scheduler->setSpawnHandler([this](const std::shared_ptr<Process>& parent) { return spawnChild(parent); });
+            scheduler->setFinishHandler([this](const std::shared_ptr<Process>& process) { onProcessFinished(process); });
+            // screen -s and load-dir before the first scheduler-start
+            for (const auto& proc : unscheduledProcesses) scheduler->addProcess(proc);
+            unscheduledProcesses.clear();
+            for (const auto& group : unscheduledGroups) addGroupOrSplit(group);
+            unscheduledGroups.clear();
+        } else {
+            // keep whatever is still queued or on a core from the last run
+            reportSplitGroups(scheduler->reconfigure(numCPU, schedulerAlgo, quantumCycles, delayPerExec));
+            scheduler->resume();
+        }
+    }
     // For simulation
-    for (int i = 0; i < batchProcessFreq; ++i) {
+    int batch = batchProcessFreq;
+    for (int i = 0; i < batch; ++i) {
+        if (!admitProcess("")) {
+            rejectedCount += batch - i - 1; // admitProcess counted this one
+            std::cout << "Initial batch stopped at max-in-flight (" << maxInFlight << "), "
+                      << batch - i << " processes not created.\n";
+            break;
+        }
         std::string procName = "p" + std::to_string(currentPID + 1);
 
-        int instCount = minInstructions + (rand() % (maxInstructions - minInstructions + 1));
-        createProcess(procName, instCount, true);
-        scheduler->addProcess(allProcesses.back());
+        int instCount = randomInstructionCount();
+        scheduler->addProcess(createProcess(procName, instCount, true));
     }
 
     //start ticking
     ticking = true;
 
-    //thick thread
+    //thick thread, parks inside waitForWork when every core is idle and nothing is queued
     schedulerThread = std::thread([this](){
-        while (ticking){
+        while (scheduler->waitForWork()){
             scheduler->tick();
-            std::this_thread::sleep_for(std::chrono::milliseconds(cpuCycleTicks));
+            evictFinishedProcesses();
+            if (!scheduler->waitForNextTick(std::chrono::milliseconds(cpuCycleTicks))) break;
         }
 
     });
 
     //make processes in the background
-    std::thread([this](){
+    generatorThread = std::thread([this](){
         while(ticking){
-            std::this_thread::sleep_for(std::chrono::seconds(batchProcessFreq));
+            {
+                std::unique_lock<std::mutex> lock(stopMutex);
+                if (stopSignal.wait_for(lock, std::chrono::seconds(batchProcessFreq.load()), [this]() { return !ticking; })) break;
+            }
+
+            if (!waitForAdmission()) break;
+            admittedCount++;
 
             // Generate a new dummy process
             std::string procName = "p" + std::to_string(++currentPID);
-            int instCount = minInstructions + (rand() % (maxInstructions - minInstructions + 1));
-            createProcess(procName, instCount, false);
-            scheduler->addProcess(allProcesses.back());
+            int instCount = randomInstructionCount();
+            scheduler->addProcess(createProcess(procName, instCount, false));
 
             //std::cout << "Auto-created process: " << procName << " with " << instCount << " instructions\n";
         }
 
-    }).detach();
+    });
 
     // // create scheduler
     // scheduler = std::make_unique<Scheduler>(numCPU, schedulerAlgo, quantumCycles);
@@ -195,6 +422,36 @@ void ConsoleManager::startScheduler() {
 
 }
 
+// trace-start <file>, convert the result with trace2json for chrome://tracing or Perfetto
+void ConsoleManager::startTrace(const std::string& path) {
+#ifdef CSOPESY_NO_TRACE
+    std::cout << "Tracing is not available, this build was compiled with CSOPESY_NO_TRACE.\n";
+    return;
+#endif
+    if (!scheduler) {
+        std::cout << "Start the scheduler before tracing.\n";
+        return;
+    }
+    if (scheduler->isTracing()) {
+        std::cout << "Already tracing. Use trace-stop first.\n";
+        return;
+    }
+    if (!scheduler->startTrace(path, cpuCycleTicks * 1000)) {
+        std::cout << "Failed to open trace file " << path << ".\n";
+        return;
+    }
+    std::cout << "Tracing scheduler events to " << path << ".\n";
+}
+
+void ConsoleManager::stopTrace() {
+    if (!scheduler || !scheduler->isTracing()) {
+        std::cout << "Not tracing.\n";
+        return;
+    }
+    scheduler->stopTrace();
+    std::cout << "Trace stopped.\n";
+}
+
 void ConsoleManager::stopScheduler() {
     if (!ticking) {
         std::cout << "Scheduler is not running.\n";
@@ -202,18 +459,24 @@ void ConsoleManager::stopScheduler() {
     }
 
     std::cout << "Stopping scheduler...\n";
-    ticking = false;
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        ticking = false;
+    }
+    stopSignal.notify_all();
+    scheduler->stop();
 
     if (schedulerThread.joinable()) {
         schedulerThread.join();
     }
+    if (generatorThread.joinable()) {
+        generatorThread.join();
+    }
 
     std::cout << "Scheduler stopped.\n";
 }
 
-void ConsoleManager::createProcess(const std::string& name, int instructionCount, bool silent) {
-   auto proc = std::make_shared<Process>(++currentPID, name, instructionCount);
-
+std::shared_ptr<Process> ConsoleManager::createProcess(const std::string& name, int instructionCount, bool silent) {
     // Generate dummy instructions
     std::vector<std::shared_ptr<Instruction>> insts;
     for (int i = 0; i < instructionCount; ++i) {
@@ -227,106 +490,408 @@ void ConsoleManager::createProcess(const std::string& name, int instructionCount
             insts.push_back(std::make_shared<PrintInstruction>("Instruction executed."));
     }
 
+    return createProcess(name, insts, silent);
+}
+
+std::shared_ptr<Process> ConsoleManager::createProcess(const std::string& name, const std::vector<std::shared_ptr<Instruction>>& insts, bool silent) {
+    int instructionCount = static_cast<int>(insts.size());
+    auto proc = std::make_shared<Process>(++currentPID, name, instructionCount);
     proc->setInstructions(insts);
 
-    processTable[name] = proc;
-    allProcesses.push_back(proc);
+    registerProcess(proc);
     if(silent){
         std::cout << "Process " << name << " created with " << instructionCount << " instructions.\n";
     }
+    return proc;
 }
 
-//screen -ls (show ongoing and finished processes)
-void ConsoleManager::listScreens() {
-    std::cout << "=== CPU Utilization Summary ===\n";
+void ConsoleManager::registerProcess(const std::shared_ptr<Process>& proc) {
+    // counted even if already finished (forked on its parent's last line), the scheduler still
+    // reports its finish and onProcessFinished takes it back off
+    liveProcesses++;
+    processes.add(proc);
+}
 
-    int totalCores = numCPU;
-    int usedCores = scheduler ? (totalCores - scheduler->getAvailableCores()) : 0;
-    int availableCores = scheduler ? scheduler->getAvailableCores() : totalCores;
+// Queues the process on the scheduler, or keeps it until scheduler-start creates one.
+bool ConsoleManager::scheduleProcess(const std::shared_ptr<Process>& proc) {
+    std::lock_guard<std::mutex> lock(configMutex);
+    if (!scheduler) {
+        unscheduledProcesses.push_back(proc);
+        return false;
+    }
+    scheduler->addProcess(proc);
+    return true;
+}
+
+void ConsoleManager::addGroupOrSplit(const std::shared_ptr<ProcessGroup>& group) {
+    if (scheduler->addGroup(group)) return;
+    // num-cpu shrank since the group was sized, run the members on their own rather than never
+    reportSplitGroups({group});
+    for (const auto& member : group->getMembers()) {
+        if (!member->isFinished()) scheduler->addProcess(member);
+    }
+}
+
+std::shared_ptr<Process> ConsoleManager::findProcess(const std::string& name) {
+    return processes.find(name);
+}
+
+// FORK/SPAWN children are named after their parent: p3-c1, p3-c2, ...
+std::shared_ptr<Process> ConsoleManager::spawnChild(const std::shared_ptr<Process>& parent) {
+    if (!admitProcess("")) return nullptr; // like a failed fork(), the parent just carries on
+    std::string childName = parent->getName() + "-c" + std::to_string(parent->getChildrenSpawned() + 1);
+    auto child = parent->fork(++currentPID, childName);
+    registerProcess(child);
+    return child;
+}
+
+bool ConsoleManager::admitProcess(const std::string& name) {
+    int limit = maxInFlight;
+    if (limit > 0 && liveProcesses >= limit) {
+        rejectedCount++;
+        if (!name.empty()) {
+            std::cout << "Rejected " << name << ": " << limit << " processes already in flight (max-in-flight).\n";
+        }
+        return false;
+    }
+    admittedCount++;
+    return true;
+}
+
+// The generator waits here instead of piling up processes. It is held back while max-in-flight
+// is reached, or from the moment the ready queue hits ready-queue-high until it drains to ready-queue-low.
+bool ConsoleManager::waitForAdmission() {
+    bool delayed = false;
+    std::unique_lock<std::mutex> lock(stopMutex);
+    while (ticking && generatorUnderPressure()) {
+        if (!delayed) {
+            delayedCount++;
+            delayed = true;
+        }
+        stopSignal.wait_for(lock, std::chrono::milliseconds(cpuCycleTicks));
+    }
+    return ticking;
+}
+
+bool ConsoleManager::generatorUnderPressure() {
+    int limit = maxInFlight;
+    if (limit > 0 && liveProcesses >= limit) return true;
+
+    int high = readyQueueHigh;
+    if (high <= 0 || !scheduler) {
+        generatorThrottled = false;
+        return false;
+    }
+    size_t queued = scheduler->getReadyQueueSize();
+    if (queued >= static_cast<size_t>(high)) generatorThrottled = true;
+    else if (queued <= static_cast<size_t>(readyQueueLow.load())) generatorThrottled = false;
+    return generatorThrottled;
+}
+
+// Runs on the scheduler thread inside tick(), so it only counts; the sweep happens after the tick.
+void ConsoleManager::onProcessFinished(const std::shared_ptr<Process>&) {
+    liveProcesses--;
+    if (evictFinished) finishedSinceSweep++;
+}
+
+// With evict-finished on, finished processes are dropped from the tables and compacted into
+// the archive. Batched so the sweep over the store stays amortized O(1) per process.
+void ConsoleManager::evictFinishedProcesses() {
+    int pending = finishedSinceSweep;
+    if (pending == 0 || static_cast<size_t>(pending) < processes.size() / 8) return;
+    finishedSinceSweep -= pending;
+    {
+        // finished gangs let go of their members too, otherwise those are never freed
+        std::lock_guard<std::mutex> lock(groupsMutex);
+        for (const auto& group : groups) {
+            if (group->isFinished()) group->releaseMembers();
+        }
+    }
+    evictedCount += processes.evictFinished(archive);
+}
 
-    std::cout << "Total Cores: " << totalCores << "\n";
-    std::cout << "Used Cores: " << usedCores << "\n";
-    std::cout << "Available Cores: " << availableCores << "\n\n";
-
-
-    std::cout << "=== Currently RUNNING/READY/WAITING processes ===\n";
-    bool anyShown = false;
-    for (auto& pair : processTable) {
-        auto proc = pair.second;
-        if (!proc->isFinished()) {
-            anyShown = true;
-            std::string stateStr;
-            switch (proc->getState()) {
-                case Process::READY: stateStr = "READY"; break;
-                case Process::RUNNING: stateStr = "RUNNING"; break;
-                case Process::WAITING: stateStr = "WAITING"; break;
-                case Process::FINISHED: stateStr = "FINISHED"; break;
+// group-create, makes <size> generated processes that are gang scheduled together
+void ConsoleManager::createGroup(const std::string& name, int size, int priority, int quantum) {
+    if (size > numCPU) {
+        std::cout << "Group " << name << " needs " << size << " cores but only " << numCPU << " exist.\n";
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(groupsMutex);
+        for (const auto& group : groups) {
+            if (group->getName() == name) {
+                std::cout << "Group " << name << " already exists.\n";
+                return;
             }
-            std::cout << "  " << proc->getName()
-                      << " (PID: " << proc->getPID()
-                      << ", Core: " << proc->getCoreID()
-                      << ", State: " << stateStr << ", Progress: "
-                      << proc->getCommandCounter() << "/" << proc->getLinesOfCode()
-                      << ")\n";
-            // std::cout << "  " << proc->getName() << " (PID: " << proc->getPID()
-            //           << ", State: " << stateStr << ")\n";
         }
     }
 
-    if (!anyShown) {
-        std::cout << "  No active processes.\n";
+    int limit = maxInFlight;
+    if (limit > 0 && liveProcesses + size > limit) {
+        rejectedCount += size;
+        std::cout << "Rejected group " << name << ": it would exceed max-in-flight (" << limit << ").\n";
+        return;
     }
-    // for (auto& pair : processTable) {
-    //     if (!pair.second->isFinished()) {
-    //         std::cout << "  " << pair.first << "\n";
-    //     }
-    // }
+    for (int i = 1; i <= size; ++i) {
+        std::string procName = name + "-" + std::to_string(i);
+        if (findProcess(procName)) {
+            std::cout << "Process " << procName << " already exists.\n";
+            return;
+        }
+    }
+    admittedCount += size;
+    std::shared_ptr<ProcessGroup> group;
+    {
+        std::lock_guard<std::mutex> lock(groupsMutex);
+        group = std::make_shared<ProcessGroup>(static_cast<int>(groups.size()) + 1, name, priority, quantum);
+        for (int i = 1; i <= size; ++i) {
+            int instCount = randomInstructionCount();
+            group->addMember(createProcess(name + "-" + std::to_string(i), instCount, false));
+        }
+        groups.push_back(group);
+    }
+
+    std::cout << "Group " << name << " created with " << size << " processes (priority " << priority
+              << ", quantum " << (quantum > 0 ? std::to_string(quantum) : "default") << ").\n";
+    std::lock_guard<std::mutex> lock(configMutex);
+    if (scheduler) {
+        addGroupOrSplit(group);
+    } else {
+        unscheduledGroups.push_back(group);
+        std::cout << "Scheduler not started yet. Group will be idle until scheduler starts.\n";
+    }
+}
+
+// load-dir, parses every program file in the directory (in parallel) and creates one process per file
+void ConsoleManager::loadDirectory(const std::string& dir) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::string error;
+    auto programs = ProgramLoader::loadDirectory(dir, error);
+    if (!error.empty()) {
+        std::cout << error << "\n";
+        return;
+    }
+
+    int loaded = 0, failed = 0, skipped = 0, rejected = 0, held = 0;
+    for (auto& program : programs) {
+        if (!program.error.empty()) {
+            if (failed++ < 5) std::cout << "  " << program.error << "\n";
+            continue;
+        }
+        if (findProcess(program.name)) {
+            skipped++;
+            continue;
+        }
+        if (rejected || !admitProcess("")) {
+            if (rejected++) rejectedCount++; // admitProcess counted the first one
+            continue;
+        }
+        if (!scheduleProcess(createProcess(program.name, program.instructions, false))) held++;
+        loaded++;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Loaded " << loaded << " programs from " << dir << " in " << elapsed.count() << "ms";
+    if (failed) std::cout << ", " << failed << " failed to parse";
+    if (skipped) std::cout << ", " << skipped << " skipped (name already in use)";
+    if (rejected) std::cout << ", " << rejected << " rejected (max-in-flight reached)";
+    std::cout << ".\n";
+    if (held) {
+        std::cout << "Scheduler not started yet. Processes will be idle until scheduler starts.\n";
+    }
+}
+
+namespace {
+
+const char* stateName(Process::ProcessState state) {
+    switch (state) {
+        case Process::READY: return "READY";
+        case Process::RUNNING: return "RUNNING";
+        case Process::WAITING: return "WAITING";
+        case Process::FINISHED: return "FINISHED";
+    }
+    return "UNKNOWN";
+}
+
+void appendRow(std::string& out, const ProcessStore::Row& row) {
+    out += "  ";
+    out += row.name;
+    out += " (PID: " + std::to_string(row.pid) + ", Core: " + std::to_string(row.coreID);
+    if (row.state == Process::FINISHED) {
+        out += ", Finished at: " + row.getFinishTimeString()
+             + ", Total Instructions: " + std::to_string(row.linesOfCode) + ")\n";
+    } else {
+        out += std::string(", State: ") + stateName(row.state) + ", Progress: "
+             + std::to_string(row.commandCounter) + "/" + std::to_string(row.linesOfCode) + ")\n";
+    }
+}
 
-    std::cout << "\n=== Finished Processes ===\n";
-    bool anyFinished = false;
-    for (const auto& pair : processTable) {
-        auto proc = pair.second;
-        if (proc->isFinished()) {
-            anyFinished = true;
-            std::cout << "  " << proc->getName()
-                      << " (PID: " << proc->getPID()
-                      << ", Core: " << proc->getCoreID()
-                      << ", Finished at: " << proc->getFinishTimeString()
-                      << ", Total Instructions: " << proc->getLinesOfCode()
-                      << ")\n";
+// Parses screen -ls options: --state=RUNNING[,READY..] --core=N --name=prefix --sort=pid|name|progress --top N
+bool parseListOptions(const std::string& options, ProcessStore::Query& query) {
+    std::istringstream in(options);
+    std::string option;
+    unsigned states = 0;
+    while (in >> option) {
+        size_t eq = option.find('=');
+        std::string key = option.substr(0, eq);
+        std::string value = eq == std::string::npos ? std::string() : option.substr(eq + 1);
+        if (key == "--top" && eq == std::string::npos && !(in >> value)) return false;
+
+        try {
+            if (key == "--state") {
+                std::istringstream names(value);
+                std::string name;
+                while (std::getline(names, name, ',')) {
+                    std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+                    if (name == "READY") states |= ProcessStore::stateBit(Process::READY);
+                    else if (name == "RUNNING") states |= ProcessStore::stateBit(Process::RUNNING);
+                    else if (name == "WAITING") states |= ProcessStore::stateBit(Process::WAITING);
+                    else if (name == "FINISHED") states |= ProcessStore::stateBit(Process::FINISHED);
+                    else return false;
+                }
+            } else if (key == "--core") {
+                query.coreID = std::stoi(value);
+            } else if (key == "--name") {
+                query.namePrefix = value;
+            } else if (key == "--sort") {
+                if (value == "pid") query.sortBy = ProcessStore::SortKey::PID;
+                else if (value == "name") query.sortBy = ProcessStore::SortKey::NAME;
+                else if (value == "progress") query.sortBy = ProcessStore::SortKey::PROGRESS;
+                else return false;
+            } else if (key == "--top") {
+                int top = std::stoi(value);
+                if (top <= 0) return false;
+                query.top = static_cast<size_t>(top);
+            } else {
+                return false;
+            }
+        } catch (...) {
+            return false;
         }
     }
-    if (!anyFinished) {
-        std::cout << "  No finished processes yet.\n";
+    if (states != 0) query.states = states;
+    return true;
+}
+
+} // namespace
+
+//screen -ls (show ongoing and finished processes), options filter/sort/limit into one list
+void ConsoleManager::listScreens(const std::string& options) {
+    ProcessStore::Query query;
+    if (!parseListOptions(options, query)) {
+        std::cout << "Usage: screen -ls [--state=READY,RUNNING,WAITING,FINISHED] [--core=N] [--name=prefix]"
+                     " [--sort=pid|name|progress] [--top N]\n";
+        return;
+    }
+
+    // built into one buffer and written once, listings can run to millions of lines
+    std::string out;
+    out += "=== CPU Utilization Summary ===\n";
+
+    int totalCores = numCPU;
+    int usedCores = scheduler ? (totalCores - scheduler->getAvailableCores()) : 0;
+    int availableCores = scheduler ? scheduler->getAvailableCores() : totalCores;
+
+    out += "Total Cores: " + std::to_string(totalCores) + "\n";
+    out += "Used Cores: " + std::to_string(usedCores) + "\n";
+    out += "Available Cores: " + std::to_string(availableCores) + "\n\n";
+
+    if (!options.empty()) {
+        auto rows = processes.query(query, &archive);
+        out += "=== Matching processes (" + std::to_string(rows.size()) + ") ===\n";
+        for (const auto& row : rows) appendRow(out, row);
+        if (rows.empty()) out += "  No matching processes.\n";
+        std::cout.write(out.data(), out.size());
+        return;
+    }
+
+    query.states = ProcessStore::ALL_STATES & ~ProcessStore::stateBit(Process::FINISHED);
+    auto active = processes.query(query, &archive);
+    out += "=== Currently RUNNING/READY/WAITING processes ===\n";
+    for (const auto& row : active) appendRow(out, row);
+    if (active.empty()) {
+        out += "  No active processes.\n";
     }
+
+    query.states = ProcessStore::stateBit(Process::FINISHED);
+    auto finished = processes.query(query, &archive);
+    out += "\n=== Finished Processes ===\n";
+    for (const auto& row : finished) appendRow(out, row);
+    if (finished.empty()) {
+        out += "  No finished processes yet.\n";
+    }
+    std::cout.write(out.data(), out.size());
 }
 
 // screen -s make process 
-void ConsoleManager::screenAttach(const std::string& name) {
-    // If process does not exist, create it
-    if (processTable.count(name) == 0) {
-        int instructionCount = minInstructions + (rand() % (maxInstructions - minInstructions + 1));
-        createProcess(name, instructionCount, true);
-
-        if (scheduler) {
-            scheduler->addProcess(processTable[name]);
+void ConsoleManager::screenAttach(const std::string& name, const std::string& programFile) {
+    // If process does not exist, create it (from the program file if one was given)
+    auto proc = findProcess(name);
+    if (!proc) {
+        // parse before admitting, a file that fails to load must not count as admitted
+        std::vector<std::shared_ptr<Instruction>> insts;
+        if (!programFile.empty()) {
+            std::string error;
+            if (!ProgramLoader::parseFile(programFile, insts, error)) {
+                std::cout << "Failed to load program: " << error << "\n";
+                return;
+            }
+        }
+
+        if (!admitProcess(name)) return;
+        if (programFile.empty()) {
+            int instructionCount = randomInstructionCount();
+            proc = createProcess(name, instructionCount, true);
         } else {
+            proc = createProcess(name, insts, true);
+        }
+
+        if (!scheduleProcess(proc)) {
             std::cout << "Scheduler not started yet. Process will be idle until scheduler starts.\n";
         }
+    } else if (!programFile.empty()) {
+        std::cout << "Process \"" << name << "\" already exists, attaching without loading " << programFile << ".\n";
     }
 
-    processScreen(processTable[name]);
+    processScreen(proc);
 }
 
 
 void ConsoleManager::screenReattach(const std::string& name) {
-    auto it = processTable.find(name);
-    if(it == processTable.end()){
-        std::cout << "Process \"" << name << "\" does not exist.\n";
+    auto proc = findProcess(name);
+    if(!proc){
+        ProcessArchive::Record record;
+        if (archive.find(name, record)) {
+            archivedScreen(record);
+        } else {
+            std::cout << "Process \"" << name << "\" does not exist.\n";
+        }
         return;
     }
 
-    processScreen(it->second);
+    processScreen(proc);
+}
+
+// Screen for an evicted process, only its summary row is left.
+void ConsoleManager::archivedScreen(const ProcessArchive::Record& record) {
+    std::string input;
+    while (true) {
+        std::cout << "[screen:" << record.name << "] > ";
+        std::getline(std::cin, input);
+
+        if (input == "exit") break;
+        else if (input == "process-smi") {
+            std::cout << "Name: " << record.name << "\n";
+            std::cout << "PID: " << record.pid << "\n";
+            std::cout << "Progress: " << record.commandCounter << " / " << record.linesOfCode << "\n";
+            std::cout << "Core ID: " << record.coreID << "\n";
+            std::cout << "Logs: (released when the process was archived)\n";
+            std::cout << "Finished at: " << record.getFinishTimeString() << "\n";
+        } else {
+            std::cout << "Unknown screen command.\n";
+        }
+    }
 }
 
 void ConsoleManager::processScreen(std::shared_ptr<Process> process) {
@@ -341,6 +906,13 @@ void ConsoleManager::processScreen(std::shared_ptr<Process> process) {
             std::cout << "PID: " << process->getPID() << "\n";
             std::cout << "Progress: " << process->getCommandCounter() << " / " << process->getLinesOfCode() << "\n";
             std::cout << "Core ID: " << process->getCoreID() << "\n";
+            if (auto parent = process->getParent()) {
+                std::cout << "Parent PID: " << parent->getPID() << "\n";
+            }
+            if (process->getChildrenSpawned() > 0) {
+                std::cout << "Children: " << process->getLiveChildren() << " running / "
+                          << process->getChildrenSpawned() << " spawned\n";
+            }
             std::cout << "Logs: " << process->getOutput() << "\n";
             if (process->isFinished()) {
                 std::cout << "Finished at: " << process->getFinishTimeString() << "\n";
@@ -352,23 +924,56 @@ void ConsoleManager::processScreen(std::shared_ptr<Process> process) {
 }
 
 void ConsoleManager::generateReport() {
-    std::ofstream outFile("csopesy-log.txt");
-    if (!outFile.is_open()) {
+    std::ofstream reportFile("csopesy-log.txt");
+    if (!reportFile.is_open()) {
         std::cout << "Failed to open report file.\n";
         return;
     }
 
-    outFile << "=== CPU Utilization Report ===\n";
-    for (auto& proc : allProcesses) {
-        outFile << "Process: " << proc->getName()
-                << " PID: " << proc->getPID()
-                << " Progress: " << proc->getCommandCounter() << " / " << proc->getLinesOfCode();
-        if(proc->isFinished()){
-            outFile << " [" << proc->getFinishTimeString() << "]";
+    // live and archived processes in PID order, built into one buffer and written once
+    auto rows = processes.query(ProcessStore::Query(), &archive);
+    std::string out = "=== CPU Utilization Report ===\n";
+    for (const auto& row : rows) {
+        out += "Process: ";
+        out += row.name;
+        out += " PID: " + std::to_string(row.pid)
+             + " Progress: " + std::to_string(row.commandCounter) + " / " + std::to_string(row.linesOfCode);
+        if (row.state == Process::FINISHED) {
+            out += " [" + row.getFinishTimeString() + "]";
         }
-        outFile <<"\n";
-            }
-    outFile.close();
+        out += "\n";
+    }
+    std::ostringstream report(std::move(out), std::ios::ate);
+
+    report << "\n=== Admission Control ===\n";
+    report << "In flight: " << liveProcesses << (maxInFlight > 0 ? " / " + std::to_string(maxInFlight) : std::string())
+           << " Admitted: " << admittedCount
+           << " Delayed: " << delayedCount
+           << " Rejected: " << rejectedCount
+           << " Evicted: " << evictedCount << "\n";
+
+    std::lock_guard<std::mutex> lock(groupsMutex);
+    if (!groups.empty()) {
+        report << "\n=== Process Groups ===\n";
+        for (const auto& group : groups) {
+            long long busy = group->getBusyCoreTicks();
+            long long idle = group->getIdleCoreTicks();
+            int utilization = (busy + idle) > 0 ? static_cast<int>(100 * busy / (busy + idle)) : 0;
+
+            report << "Group: " << group->getName()
+                   << " Priority: " << group->getPriority()
+                   << " Members: " << group->getFinishedCount() << " / " << group->getMemberCount() << " finished"
+                   << " Progress: " << group->getProgress() << " / " << group->getTotalInstructions()
+                   << " Dispatches: " << group->getDispatchCount()
+                   << " Preemptions: " << group->getPreemptionCount()
+                   << " Running ticks: " << group->getRunningTicks()
+                   << " Idle core ticks: " << idle
+                   << " Core utilization: " << utilization << "%\n";
+        }
+    }
+    std::string text = report.str();
+    reportFile.write(text.data(), text.size());
+    reportFile.close();
     std::cout << "Report saved to csopesy-log.txt.\n";
 }
 
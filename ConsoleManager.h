@@ -6,8 +6,13 @@
 #include <vector>
 #include "Process.h"
 #include "Scheduler.h"
+#include "ProcessGroup.h"
+#include "ProcessArchive.h"
+#include "ProcessStore.h"
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 class ConsoleManager {
 public:
@@ -17,9 +22,15 @@ public:
     void initialize(); // Loads config and initializes the scheduler
     void startScheduler();
     void stopScheduler();
-    void createProcess(const std::string& name, int instructionCount, bool silent);
-    void listScreens(); // screen -ls
-    void screenAttach(const std::string& name); // screen -s <name>
+    void reconfigure(); // reloads config.txt and applies it to the live scheduler
+    void startTrace(const std::string& path); // trace-start <file>
+    void stopTrace(); // trace-stop
+    std::shared_ptr<Process> createProcess(const std::string& name, int instructionCount, bool silent);
+    std::shared_ptr<Process> createProcess(const std::string& name, const std::vector<std::shared_ptr<Instruction>>& insts, bool silent);
+    void loadDirectory(const std::string& dir); // load-dir <dir>
+    void createGroup(const std::string& name, int size, int priority, int quantum); // group-create
+    void listScreens(const std::string& options = ""); // screen -ls [filters]
+    void screenAttach(const std::string& name, const std::string& programFile = ""); // screen -s <name> [file]
     void screenReattach(const std::string& name); // screen -r <name>
     void generateReport(); // report-util
     int getCurrentPID() const;
@@ -29,25 +40,70 @@ private:
     ConsoleManager();
     static ConsoleManager* instance;
     bool isInitialized = false;
-    int currentPID = 0;
+    std::atomic<int> currentPID{0};
 
     //adsded
     std::unique_ptr<Scheduler> scheduler;
     std::thread schedulerThread;
+    std::thread generatorThread;
     std::atomic<bool> ticking{false};
+    std::mutex stopMutex; // lets the generator sleep on stopSignal instead of a plain sleep_for
+    std::condition_variable stopSignal;
+    std::thread configWatcherThread;
+    std::atomic<bool> watchingConfig{false};
+#ifndef _WIN32
+    int configWatchStop[2] = {-1, -1}; // pipe, a byte on it wakes the watcher to exit
+#endif
     //added
 
-    std::unordered_map<std::string, std::shared_ptr<Process>> processTable;
-    std::vector<std::shared_ptr<Process>> allProcesses;
+    ProcessStore processes; // the generator and scheduler threads add to it, the CLI queries it
+    std::mutex groupsMutex; // groups and their member lists, finished gangs are released by the eviction sweep
+    std::vector<std::shared_ptr<ProcessGroup>> groups;
+    std::vector<std::shared_ptr<Process>> unscheduledProcesses; // made before the first scheduler-start
+    std::vector<std::shared_ptr<ProcessGroup>> unscheduledGroups;
 
     void processScreen(std::shared_ptr<Process> process);
-    void loadConfig();
+    void archivedScreen(const ProcessArchive::Record& record);
+    void registerProcess(const std::shared_ptr<Process>& proc);
+    std::shared_ptr<Process> findProcess(const std::string& name);
+    std::shared_ptr<Process> spawnChild(const std::shared_ptr<Process>& parent);
+    bool scheduleProcess(const std::shared_ptr<Process>& proc); // false if held until scheduler-start
+    void addGroupOrSplit(const std::shared_ptr<ProcessGroup>& group); // caller holds configMutex
 
-    int numCPU = 1;
+    // admission control
+    bool admitProcess(const std::string& name); // CLI/spawn path, rejects at max-in-flight
+    bool waitForAdmission(); // generator path, blocks while under pressure
+    bool generatorUnderPressure();
+    void onProcessFinished(const std::shared_ptr<Process>& process);
+    void evictFinishedProcesses();
+    void reportSplitGroups(const std::vector<std::shared_ptr<ProcessGroup>>& split) const;
+    bool loadConfig();
+    std::string getSchedulerAlgo() const;
+    int randomInstructionCount() const;
+    void startConfigWatcher();
+    void stopConfigWatcher();
+
+    // config can be reloaded by the watcher thread while the generator reads it
+    mutable std::mutex configMutex; // guards schedulerAlgo, scheduler creation, the unscheduled lists and the min/max pair
+    std::atomic<int> numCPU{1};
     std::string schedulerAlgo = "fcfs";
-    int quantumCycles = 3;
-    int batchProcessFreq = 1;
-    int minInstructions = 5;
-    int maxInstructions = 10;
-    int delayPerExec = 0;
+    std::atomic<int> quantumCycles{3};
+    std::atomic<int> batchProcessFreq{1};
+    std::atomic<int> minInstructions{5};
+    std::atomic<int> maxInstructions{10};
+    std::atomic<int> delayPerExec{0};
+    std::atomic<int> maxInFlight{0};    // 0 = unlimited
+    std::atomic<int> readyQueueHigh{0}; // 0 = no watermark
+    std::atomic<int> readyQueueLow{0};
+    std::atomic<bool> evictFinished{true};
+
+    std::atomic<int> liveProcesses{0}; // created and not finished yet
+    std::atomic<int> finishedSinceSweep{0};
+    std::atomic<long long> admittedCount{0};
+    std::atomic<long long> delayedCount{0};
+    std::atomic<long long> rejectedCount{0};
+    std::atomic<long long> evictedCount{0};
+    bool generatorThrottled = false; // generator thread only, between the watermarks
+
+    ProcessArchive archive; // evicted finished processes
 };
\ No newline at end of file
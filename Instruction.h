@@ -1,18 +1,29 @@
 #pragma once
 #include <string>
-#include <unordered_map>
 #include <cstdint>
+#include "RegisterFile.h"
+
+// Instructions that act on the process itself (creating children, waiting for them).
+// Process handles these directly instead of calling execute().
+enum class ControlOp {
+    NONE, FORK, WAIT
+};
 
 class Instruction {
 public:
     virtual void execute(
         const std::string& processName,
         int coreID,
-        std::unordered_map<std::string, uint16_t>& variables,
+        RegisterFile& variables,
         std::string& outputLog,
         bool& sleeping,
         int& sleepTicks
     ) = 0;
 
+    // true if execute() may change variables; a process copies a shared register file first
+    virtual bool writesVariables() const { return false; }
+    virtual ControlOp getControlOp() const { return ControlOp::NONE; }
+    virtual int getChildCount() const { return 0; } // children made by a FORK op
+
     virtual ~Instruction() = default;
 };
@@ -2,9 +2,9 @@
 #pragma once
 
 #include "Instruction.h"
+#include "SymbolTable.h"
 #include <string>
 #include <sstream>
-#include <unordered_map>
 #include <chrono>
 #include <iomanip>
 #include <ctime>
@@ -18,7 +18,7 @@ public:
     void execute(
         const std::string& processName,
         int coreID,
-        std::unordered_map<std::string, uint16_t>& variables,
+        RegisterFile& variables,
         std::string& outputLog,
         bool& sleeping,
         int& sleepTicks
@@ -36,75 +36,128 @@ public:
 };
 
 class DeclareInstruction : public Instruction {
-    std::string var;
+    uint16_t var; // SymbolTable id
     uint16_t value;
 public:
-    DeclareInstruction(const std::string& var, uint16_t value) : var(var), value(value) {}
+    DeclareInstruction(const std::string& var, uint16_t value) : var(SymbolTable::getInstance().intern(var)), value(value) {}
+
+    bool writesVariables() const override { return true; }
 
     void execute(
         const std::string&,
         int,
-        std::unordered_map<std::string, uint16_t>& variables,
+        RegisterFile& variables,
         std::string&,
         bool&,
         int&
     ) override {
-        variables[var] = value;
+        variables.set(var, value);
     }
 };
 
 class AddInstruction : public Instruction {
-    std::string dest, op1, op2;
+    uint16_t dest, op1, op2; // SymbolTable ids, op2 unused when isOp2Value
     bool isOp2Value;
     uint16_t value2;
 
 public:
     AddInstruction(const std::string& dest, const std::string& op1, const std::string& op2)
-        : dest(dest), op1(op1), op2(op2), isOp2Value(false) {
+        : dest(SymbolTable::getInstance().intern(dest)), op1(SymbolTable::getInstance().intern(op1)),
+          op2(0), isOp2Value(false), value2(0) {
         try {
             value2 = std::stoi(op2);
             isOp2Value = true;
-        } catch (...) {}
+        } catch (...) {
+            this->op2 = SymbolTable::getInstance().intern(op2);
+        }
     }
 
+    bool writesVariables() const override { return true; }
+
     void execute(
         const std::string&,
         int,
-        std::unordered_map<std::string, uint16_t>& variables,
+        RegisterFile& variables,
         std::string&,
         bool&,
         int&
     ) override {
-        uint16_t v1 = variables[op1];
-        uint16_t v2 = isOp2Value ? value2 : variables[op2];
-        variables[dest] = v1 + v2;
+        uint16_t v1 = variables.get(op1);
+        uint16_t v2 = isOp2Value ? value2 : variables.get(op2);
+        variables.set(dest, v1 + v2);
     }
 };
 
 class SubtractInstruction : public Instruction {
-    std::string dest, op1, op2;
+    uint16_t dest, op1, op2; // SymbolTable ids, op2 unused when isOp2Value
     bool isOp2Value;
     uint16_t value2;
 
 public:
     SubtractInstruction(const std::string& dest, const std::string& op1, const std::string& op2)
-        : dest(dest), op1(op1), op2(op2), isOp2Value(false) {
+        : dest(SymbolTable::getInstance().intern(dest)), op1(SymbolTable::getInstance().intern(op1)),
+          op2(0), isOp2Value(false), value2(0) {
         try {
             value2 = std::stoi(op2);
             isOp2Value = true;
-        } catch (...) {}
+        } catch (...) {
+            this->op2 = SymbolTable::getInstance().intern(op2);
+        }
     }
 
+    bool writesVariables() const override { return true; }
+
     void execute(
         const std::string&,
         int,
-        std::unordered_map<std::string, uint16_t>& variables,
+        RegisterFile& variables,
         std::string&,
         bool&,
         int&
     ) override {
-        uint16_t v1 = variables[op1];
-        uint16_t v2 = isOp2Value ? value2 : variables[op2];
-        variables[dest] = v1 - v2;
+        uint16_t v1 = variables.get(op1);
+        uint16_t v2 = isOp2Value ? value2 : variables.get(op2);
+        variables.set(dest, v1 - v2);
+    }
+};
+
+class SleepInstruction : public Instruction {
+    uint8_t ticks;
+
+public:
+    SleepInstruction(uint8_t ticks) : ticks(ticks) {}
+
+    void execute(
+        const std::string&,
+        int,
+        RegisterFile&,
+        std::string&,
+        bool& sleeping,
+        int& sleepTicks
+    ) override {
+        sleeping = true;
+        sleepTicks = ticks;
     }
 };
+
+// FORK makes one child, SPAWN n makes n. Children share the program and start at the next
+// instruction with a copy-on-write view of the parent's variables.
+class ForkInstruction : public Instruction {
+    int children;
+
+public:
+    ForkInstruction(int children = 1) : children(children) {}
+
+    ControlOp getControlOp() const override { return ControlOp::FORK; }
+    int getChildCount() const override { return children; }
+
+    void execute(const std::string&, int, RegisterFile&, std::string&, bool&, int&) override {}
+};
+
+// Blocks (WAITING) until every child of the process has finished.
+class WaitInstruction : public Instruction {
+public:
+    ControlOp getControlOp() const override { return ControlOp::WAIT; }
+
+    void execute(const std::string&, int, RegisterFile&, std::string&, bool&, int&) override {}
+};
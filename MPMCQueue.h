@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free multi-producer multi-consumer ring (Dmitry Vyukov's algorithm).
+// Every slot carries a sequence number telling producers and consumers whose turn it is,
+// so a push or pop is one CAS on the shared position plus a store to the slot.
+// The two positions sit on their own cache lines so producers and consumers don't false share.
+template <typename T>
+class MPMCQueue {
+public:
+    // capacity is rounded up to a power of two
+    explicit MPMCQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    // Returns false if the ring is full.
+    bool tryPush(T value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns false if the ring is empty.
+    bool tryPop(T& value) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->data);
+        cell->data = T(); // don't keep the popped object alive in the slot
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Only exact when no push or pop is in flight.
+    size_t sizeApprox() const {
+        size_t tail = enqueuePos.load(std::memory_order_acquire);
+        size_t head = dequeuePos.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool emptyApprox() const {
+        return sizeApprox() == 0;
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    alignas(CACHE_LINE) std::atomic<size_t> enqueuePos{0};
+    alignas(CACHE_LINE) std::atomic<size_t> dequeuePos{0};
+    char padding[CACHE_LINE - sizeof(std::atomic<size_t>)];
+};
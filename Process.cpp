@@ -17,8 +17,28 @@ void Process::executeNextInstruction(int coreID) {
         return;
     }
 
-    if (commandCounter < linesOfCode && commandCounter < instructions.size()) {
-        instructions[commandCounter]->execute(name, coreID, variables, outputLog, sleeping, sleepTicks);
+    if (instructions && commandCounter < linesOfCode && commandCounter < static_cast<int>(instructions->size())) {
+        const auto& instruction = (*instructions)[commandCounter];
+        switch (instruction->getControlOp()) {
+            case ControlOp::FORK:
+                pendingForks += instruction->getChildCount();
+                break;
+            case ControlOp::WAIT:
+                if (liveChildren > 0) {
+                    currentState = WAITING; // retried once the last child finishes
+                    return;
+                }
+                if (currentState == WAITING) currentState = RUNNING;
+                break;
+            case ControlOp::NONE:
+                if (!variables) {
+                    variables = std::make_shared<RegisterFile>();
+                } else if (instruction->writesVariables() && variables.use_count() > 1) {
+                    variables = std::make_shared<RegisterFile>(*variables); // copy on write
+                }
+                instruction->execute(name, coreID, *variables, outputLog, sleeping, sleepTicks);
+                break;
+        }
         commandCounter++;
     }
 
@@ -32,7 +52,11 @@ bool Process::isFinished() const {
     return currentState == FINISHED;
 }
 
-std::string Process::getName() const {
+bool Process::isSleeping() const {
+    return sleeping;
+}
+
+const std::string& Process::getName() const {
     return name;
 }
 
@@ -69,20 +93,62 @@ void Process::setState(ProcessState newState) {
 }
 
 void Process::setInstructions(const std::vector<std::shared_ptr<Instruction>>& insts) {
-    instructions = insts;
+    instructions = std::make_shared<const std::vector<std::shared_ptr<Instruction>>>(insts);
+}
+
+int Process::takePendingForks() {
+    int count = pendingForks;
+    pendingForks = 0;
+    return count;
+}
+
+std::shared_ptr<Process> Process::fork(int childPID, const std::string& childName) {
+    auto child = std::make_shared<Process>(childPID, childName, linesOfCode);
+    child->instructions = instructions;
+    child->variables = variables;
+    child->commandCounter = commandCounter;
+    child->parent = weak_from_this();
+    liveChildren++;
+    childrenSpawned++;
+
+    if (child->commandCounter >= child->linesOfCode) { // forked on the last line
+        child->currentState = FINISHED;
+        child->markFinished();
+    }
+    return child;
+}
+
+std::shared_ptr<Process> Process::getParent() const {
+    return parent.lock();
+}
+
+int Process::getLiveChildren() const {
+    return liveChildren;
+}
+
+int Process::getChildrenSpawned() const {
+    return childrenSpawned;
 }
 
 void Process::markFinished() {
     if (!hasFinishTime) {
         finishTime = std::chrono::system_clock::now();
         hasFinishTime = true;
+        if (auto p = parent.lock()) p->liveChildren--;
     }
 }
 
+std::chrono::system_clock::time_point Process::getFinishTime() const {
+    return finishTime;
+}
+
 std::string Process::getFinishTimeString() const {
     if (!hasFinishTime) return "N/A";
-    std::time_t finish_time = std::chrono::system_clock::to_time_t(finishTime);
-    std::tm local_tm = *std::localtime(&finish_time);
+    return formatTime(std::chrono::system_clock::to_time_t(finishTime));
+}
+
+std::string Process::formatTime(std::time_t time) {
+    std::tm local_tm = *std::localtime(&time);
     std::ostringstream oss;
     oss << std::put_time(&local_tm, "%H:%M:%S %m/%d/%Y");
     return oss.str();
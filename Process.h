@@ -5,9 +5,10 @@
 #include <memory>
 #include <cstdint>
 #include <chrono>
+#include <ctime>
 #include "Instruction.h"
 
-class Process {
+class Process : public std::enable_shared_from_this<Process> {
 public:
     enum ProcessState {
         READY, RUNNING, WAITING, FINISHED
@@ -16,8 +17,9 @@ public:
     Process(int pid, const std::string& name, int lines);
     void executeNextInstruction(int coreID);
     bool isFinished() const;
+    bool isSleeping() const;
 
-    std::string getName() const;
+    const std::string& getName() const;
     int getPID() const;
     int getCommandCounter() const;
     int getLinesOfCode() const;
@@ -29,8 +31,19 @@ public:
     void setState(ProcessState newState);
     void setInstructions(const std::vector<std::shared_ptr<Instruction>>& insts);
 
+    // FORK/SPAWN/WAIT support. The scheduler takes the pending count after each instruction
+    // and calls fork() for each child; children share this process's program image.
+    int takePendingForks();
+    std::shared_ptr<Process> fork(int childPID, const std::string& childName);
+    std::shared_ptr<Process> getParent() const;
+    int getLiveChildren() const;
+    int getChildrenSpawned() const;
+
     //for the finished time sa process
     std::string getFinishTimeString() const;
+    // "HH:MM:SS MM/DD/YYYY" in local time, also used for archived and listed processes
+    static std::string formatTime(std::time_t time);
+    std::chrono::system_clock::time_point getFinishTime() const;
     void markFinished();
 
 private:
@@ -41,10 +54,17 @@ private:
     int coreID;
     ProcessState currentState;
 
-    std::vector<std::shared_ptr<Instruction>> instructions;
-    std::unordered_map<std::string, uint16_t> variables;
+    // shared by every process forked from the same program
+    std::shared_ptr<const std::vector<std::shared_ptr<Instruction>>> instructions;
+    // fixed slots keyed by SymbolTable id, shared with forked children until one of them writes
+    std::shared_ptr<RegisterFile> variables;
     std::string outputLog;
 
+    std::weak_ptr<Process> parent;
+    int liveChildren = 0;
+    int childrenSpawned = 0;
+    int pendingForks = 0;
+
     bool sleeping = false;
     int sleepTicks = 0;
     std::chrono::system_clock::time_point finishTime;
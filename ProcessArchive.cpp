@@ -0,0 +1,73 @@
+#include "ProcessArchive.h"
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+
+std::string ProcessArchive::Record::getFinishTimeString() const {
+    return Process::formatTime(static_cast<std::time_t>(finishTime));
+}
+
+void ProcessArchive::append(const Process& process) {
+    std::unique_lock<std::shared_mutex> lock(archiveMutex);
+    uint32_t row = static_cast<uint32_t>(pids.size());
+
+    // a reused name (e.g. screen -s after the first one finished) keeps its name id
+    const std::string& processName = process.getName();
+    uint32_t nameId;
+    auto existing = rowByName.find(std::string_view(processName));
+    if (existing != rowByName.end()) {
+        nameId = nameIds[existing->second];
+    } else {
+        nameId = static_cast<uint32_t>(names.size());
+        names.push_back(storeName(processName));
+    }
+    std::string_view name = names[nameId];
+
+    pids.push_back(process.getPID());
+    nameIds.push_back(nameId);
+    coreIDs.push_back(static_cast<int16_t>(process.getCoreID()));
+    commandCounters.push_back(process.getCommandCounter());
+    linesOfCode.push_back(process.getLinesOfCode());
+    finishTimes.push_back(std::chrono::system_clock::to_time_t(process.getFinishTime()));
+    rowByName[name] = row;
+}
+
+size_t ProcessArchive::size() const {
+    std::shared_lock<std::shared_mutex> lock(archiveMutex);
+    return pids.size();
+}
+
+ProcessArchive::Record ProcessArchive::get(size_t row) const {
+    std::shared_lock<std::shared_mutex> lock(archiveMutex);
+    return recordAt(row);
+}
+
+bool ProcessArchive::find(const std::string& name, Record& out) const {
+    std::shared_lock<std::shared_mutex> lock(archiveMutex);
+    auto it = rowByName.find(name);
+    if (it == rowByName.end()) return false;
+    out = recordAt(it->second);
+    return true;
+}
+
+std::string_view ProcessArchive::storeName(const std::string& name) {
+    if (name.size() > NAME_BLOCK_SIZE) { // gets a block of its own
+        nameBlocks.emplace_back(new char[name.size()]);
+        std::memcpy(nameBlocks.back().get(), name.data(), name.size());
+        nameBlockUsed = NAME_BLOCK_SIZE;
+        return std::string_view(nameBlocks.back().get(), name.size());
+    }
+    if (name.size() > NAME_BLOCK_SIZE - nameBlockUsed) {
+        nameBlocks.emplace_back(new char[NAME_BLOCK_SIZE]);
+        nameBlockUsed = 0;
+    }
+    char* dest = nameBlocks.back().get() + nameBlockUsed;
+    std::memcpy(dest, name.data(), name.size());
+    nameBlockUsed += name.size();
+    return std::string_view(dest, name.size());
+}
+
+ProcessArchive::Record ProcessArchive::recordAt(size_t row) const {
+    return {pids[row], names[nameIds[row]], coreIDs[row], commandCounters[row], linesOfCode[row], finishTimes[row]};
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Process.h"
+
+// Append-only store for finished processes. Each process is reduced to one row of small
+// columns (pid, name id, core, counters, finish time) and its program, variables and
+// log are released, so memory grows by a few dozen bytes per finished process.
+class ProcessArchive {
+public:
+    struct Record {
+        int pid;
+        std::string_view name; // stays valid for the archive's lifetime
+        int coreID;
+        int commandCounter;
+        int linesOfCode;
+        int64_t finishTime; // seconds since the epoch
+
+        std::string getFinishTimeString() const;
+    };
+
+    void append(const Process& process);
+    size_t size() const;
+    Record get(size_t row) const;
+    bool find(const std::string& name, Record& out) const; // latest row with that name
+
+    // Calls fn(record) for rows [begin, end) under one read lock.
+    template <typename Fn>
+    void forEach(size_t begin, size_t end, Fn fn) const {
+        std::shared_lock<std::shared_mutex> lock(archiveMutex);
+        if (end > pids.size()) end = pids.size();
+        for (size_t row = begin; row < end; ++row) fn(recordAt(row));
+    }
+
+private:
+    static constexpr size_t NAME_BLOCK_SIZE = 64 * 1024;
+
+    mutable std::shared_mutex archiveMutex; // appended from the scheduler thread, read from the CLI
+
+    std::vector<int32_t> pids;
+    std::vector<uint32_t> nameIds;
+    std::vector<int16_t> coreIDs;
+    std::vector<int32_t> commandCounters;
+    std::vector<int32_t> linesOfCode;
+    std::vector<int64_t> finishTimes;
+
+    // names are copied into fixed blocks that never move, so the views stay valid
+    std::vector<std::unique_ptr<char[]>> nameBlocks;
+    size_t nameBlockUsed = NAME_BLOCK_SIZE;
+    std::vector<std::string_view> names; // by name id
+    std::unordered_map<std::string_view, uint32_t> rowByName; // latest row per name
+
+    std::string_view storeName(const std::string& name);
+    Record recordAt(size_t row) const;
+};
@@ -0,0 +1,128 @@
+#include "ProcessGroup.h"
+
+ProcessGroup::ProcessGroup(int groupID, const std::string& name, int priority, int quantum)
+    : groupID(groupID), name(name), priority(priority), quantum(quantum) {}
+
+void ProcessGroup::addMember(std::shared_ptr<Process> process) {
+    members.push_back(process);
+    memberCores.push_back(-1);
+}
+
+const std::vector<std::shared_ptr<Process>>& ProcessGroup::getMembers() const {
+    return members;
+}
+
+int ProcessGroup::getGroupID() const {
+    return groupID;
+}
+
+std::string ProcessGroup::getName() const {
+    return name;
+}
+
+int ProcessGroup::getPriority() const {
+    return priority;
+}
+
+int ProcessGroup::getQuantum() const {
+    return quantum;
+}
+
+int ProcessGroup::getMemberCount() const {
+    return static_cast<int>(members.size()) + releasedMembers;
+}
+
+int ProcessGroup::getRunnableCount() const {
+    return getMemberCount() - getFinishedCount();
+}
+
+int ProcessGroup::getFinishedCount() const {
+    int count = releasedMembers;
+    for (const auto& member : members) {
+        if (member->isFinished()) count++;
+    }
+    return count;
+}
+
+long long ProcessGroup::getProgress() const {
+    long long progress = releasedProgress;
+    for (const auto& member : members) progress += member->getCommandCounter();
+    return progress;
+}
+
+long long ProcessGroup::getTotalInstructions() const {
+    long long total = releasedInstructions;
+    for (const auto& member : members) total += member->getLinesOfCode();
+    return total;
+}
+
+void ProcessGroup::releaseMembers() {
+    if (!isFinished()) return;
+    releasedProgress = getProgress();
+    releasedInstructions = getTotalInstructions();
+    releasedMembers += static_cast<int>(members.size());
+    members.clear();
+    memberCores.clear();
+}
+
+bool ProcessGroup::isFinished() const {
+    return getRunnableCount() == 0;
+}
+
+int ProcessGroup::getMemberCore(size_t index) const {
+    return memberCores[index];
+}
+
+void ProcessGroup::setMemberCore(size_t index, int coreID) {
+    memberCores[index] = coreID;
+}
+
+int ProcessGroup::getRemainingQuantum() const {
+    return remainingQuantum;
+}
+
+void ProcessGroup::setRemainingQuantum(int ticks) {
+    remainingQuantum = ticks;
+}
+
+uint64_t ProcessGroup::getQueuedTick() const {
+    return queuedTick;
+}
+
+void ProcessGroup::setQueuedTick(uint64_t tick) {
+    queuedTick = tick;
+}
+
+void ProcessGroup::recordDispatch() {
+    dispatchCount++;
+}
+
+void ProcessGroup::recordPreemption() {
+    preemptionCount++;
+}
+
+void ProcessGroup::recordTick(int busyCores, int idleCores) {
+    runningTicks++;
+    busyCoreTicks += busyCores;
+    idleCoreTicks += idleCores;
+}
+
+int ProcessGroup::getDispatchCount() const {
+    return dispatchCount;
+}
+
+int ProcessGroup::getPreemptionCount() const {
+    return preemptionCount;
+}
+
+long long ProcessGroup::getRunningTicks() const {
+    return runningTicks;
+}
+
+long long ProcessGroup::getBusyCoreTicks() const {
+    return busyCoreTicks;
+}
+
+long long ProcessGroup::getIdleCoreTicks() const {
+    return idleCoreTicks;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "Process.h"
+
+// A set of processes that are gang scheduled: every unfinished member is put on a core
+// in the same tick or none are, and they are preempted together.
+class ProcessGroup {
+public:
+    ProcessGroup(int groupID, const std::string& name, int priority = 0, int quantum = 0);
+
+    void addMember(std::shared_ptr<Process> process);
+    const std::vector<std::shared_ptr<Process>>& getMembers() const;
+
+    int getGroupID() const;
+    std::string getName() const;
+    int getPriority() const; // higher runs first
+    int getQuantum() const;  // 0 = use the scheduler's quantum
+    int getMemberCount() const;
+    int getRunnableCount() const;
+    int getFinishedCount() const;
+    bool isFinished() const;
+    long long getProgress() const;          // instructions executed by all members
+    long long getTotalInstructions() const;
+
+    // Once the gang is finished: folds the members into the totals above and drops the
+    // Process pointers, so evicted members can actually be freed.
+    void releaseMembers();
+
+    // core each member sits on while the gang is dispatched, -1 otherwise (same index as getMembers())
+    int getMemberCore(size_t index) const;
+    void setMemberCore(size_t index, int coreID);
+
+    int getRemainingQuantum() const;
+    void setRemainingQuantum(int ticks);
+
+    // scheduler tick the gang was last queued at, for holding cores back once it has waited too long
+    uint64_t getQueuedTick() const;
+    void setQueuedTick(uint64_t tick);
+
+    // group-wide stats, updated by the scheduler
+    void recordDispatch();
+    void recordPreemption();
+    void recordTick(int busyCores, int idleCores);
+    int getDispatchCount() const;
+    int getPreemptionCount() const;
+    long long getRunningTicks() const;
+    long long getBusyCoreTicks() const;
+    long long getIdleCoreTicks() const; // cores held by finished or waiting members while the gang runs
+
+private:
+    int groupID;
+    std::string name;
+    int priority;
+    int quantum;
+    int remainingQuantum = 0;
+    uint64_t queuedTick = 0;
+
+    std::vector<std::shared_ptr<Process>> members;
+    std::vector<int> memberCores;
+    int releasedMembers = 0;
+    long long releasedProgress = 0;
+    long long releasedInstructions = 0;
+
+    int dispatchCount = 0;
+    int preemptionCount = 0;
+    long long runningTicks = 0;
+    long long busyCoreTicks = 0;
+    long long idleCoreTicks = 0;
+};
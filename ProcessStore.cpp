@@ -0,0 +1,204 @@
+#include "ProcessStore.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <queue>
+#include <thread>
+
+namespace {
+
+using Row = ProcessStore::Row;
+using RowLess = bool (*)(const Row&, const Row&);
+
+bool byPID(const Row& a, const Row& b) {
+    return a.pid < b.pid;
+}
+
+bool byName(const Row& a, const Row& b) {
+    return a.name != b.name ? a.name < b.name : a.pid < b.pid;
+}
+
+bool byProgress(const Row& a, const Row& b) { // most executed instructions first
+    return a.commandCounter != b.commandCounter ? a.commandCounter > b.commandCounter : a.pid < b.pid;
+}
+
+RowLess comparatorFor(ProcessStore::SortKey key) {
+    switch (key) {
+        case ProcessStore::SortKey::NAME: return byName;
+        case ProcessStore::SortKey::PROGRESS: return byProgress;
+        case ProcessStore::SortKey::PID: break;
+    }
+    return byPID;
+}
+
+// Collects one task's matches. With a top limit it keeps a max-heap of the best rows seen so
+// far, so a row that can't make the cut is rejected before it is copied.
+class PartCollector {
+public:
+    PartCollector(std::vector<Row>& part, RowLess less, size_t top) : part(part), less(less), top(top) {}
+
+    void offer(Row&& row) {
+        if (top == 0 || part.size() < top) {
+            part.push_back(std::move(row));
+            if (top > 0) std::push_heap(part.begin(), part.end(), less);
+        } else if (less(row, part.front())) {
+            std::pop_heap(part.begin(), part.end(), less);
+            part.back() = std::move(row);
+            std::push_heap(part.begin(), part.end(), less);
+        }
+    }
+
+    // only worth building the full row when this is true
+    bool wouldKeep(const Row& key) const {
+        return top == 0 || part.size() < top || less(key, part.front());
+    }
+
+    void finish() {
+        if (top > 0) std::sort_heap(part.begin(), part.end(), less);
+        else std::sort(part.begin(), part.end(), less);
+    }
+
+private:
+    std::vector<Row>& part;
+    RowLess less;
+    size_t top;
+};
+
+} // namespace
+
+std::string ProcessStore::Row::getFinishTimeString() const {
+    return Process::formatTime(static_cast<std::time_t>(finishTime));
+}
+
+ProcessStore::ProcessStore(size_t shardCount)
+    : shards(new Shard[std::max<size_t>(shardCount, 1)]), shardCount(std::max<size_t>(shardCount, 1)) {}
+
+ProcessStore::Shard& ProcessStore::shardFor(const std::string& name) const {
+    return shards[std::hash<std::string>()(name) % shardCount];
+}
+
+void ProcessStore::add(const std::shared_ptr<Process>& proc) {
+    Shard& shard = shardFor(proc->getName());
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.byName[proc->getName()] = proc;
+    shard.processes.push_back(proc);
+    count++;
+}
+
+std::shared_ptr<Process> ProcessStore::find(const std::string& name) const {
+    Shard& shard = shardFor(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.byName.find(name);
+    return it == shard.byName.end() ? nullptr : it->second;
+}
+
+size_t ProcessStore::size() const {
+    return count;
+}
+
+size_t ProcessStore::evictFinished(ProcessArchive& archive) {
+    std::unique_lock<std::shared_mutex> evictionLock(evictionMutex);
+    size_t evicted = 0;
+    for (size_t i = 0; i < shardCount; ++i) {
+        Shard& shard = shards[i];
+        std::vector<std::shared_ptr<Process>> finished;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto firstFinished = std::stable_partition(shard.processes.begin(), shard.processes.end(),
+                [](const std::shared_ptr<Process>& proc) { return !proc->isFinished(); });
+            finished.assign(firstFinished, shard.processes.end());
+            shard.processes.erase(firstFinished, shard.processes.end());
+            for (const auto& proc : finished) {
+                auto it = shard.byName.find(proc->getName());
+                if (it != shard.byName.end() && it->second == proc) shard.byName.erase(it);
+            }
+        }
+        // the last reference is dropped here, finished gangs released theirs earlier in the sweep
+        for (const auto& proc : finished) {
+            archive.append(*proc);
+        }
+        evicted += finished.size();
+    }
+    count -= evicted;
+    return evicted;
+}
+
+std::vector<ProcessStore::Row> ProcessStore::query(const Query& query, const ProcessArchive* archive) const {
+    std::shared_lock<std::shared_mutex> evictionLock(evictionMutex);
+    RowLess less = comparatorFor(query.sortBy);
+
+    auto matches = [&](int coreID, Process::ProcessState state, std::string_view name) {
+        return (query.states & stateBit(state)) != 0
+            && (!query.coreID || *query.coreID == coreID)
+            && name.substr(0, query.namePrefix.size()) == query.namePrefix;
+    };
+
+    // one task per shard plus one per chunk of archived rows, each filtered and sorted on its own
+    size_t archivedRows = (archive && (query.states & stateBit(Process::FINISHED))) ? archive->size() : 0;
+    size_t taskCount = shardCount + (archivedRows + ARCHIVE_CHUNK - 1) / ARCHIVE_CHUNK;
+    std::vector<std::vector<Row>> parts(taskCount);
+
+    auto scanShard = [&](const Shard& shard, PartCollector& part) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& proc : shard.processes) {
+            Row row{proc->getPID(), proc->getName(), proc->getCoreID(), proc->getState(),
+                    proc->getCommandCounter(), proc->getLinesOfCode(), 0, nullptr};
+            if (!matches(row.coreID, row.state, row.name) || !part.wouldKeep(row)) continue;
+            if (row.state == Process::FINISHED) {
+                row.finishTime = std::chrono::system_clock::to_time_t(proc->getFinishTime());
+            }
+            row.process = proc;
+            part.offer(std::move(row));
+        }
+    };
+    auto scanArchive = [&](size_t begin, PartCollector& part) {
+        archive->forEach(begin, std::min(begin + ARCHIVE_CHUNK, archivedRows), [&](const ProcessArchive::Record& record) {
+            if (!matches(record.coreID, Process::FINISHED, record.name)) return;
+            part.offer({record.pid, record.name, record.coreID, Process::FINISHED,
+                        record.commandCounter, record.linesOfCode, record.finishTime, nullptr});
+        });
+    };
+
+    // small stores are scanned on the calling thread, threads only pay off for large scans
+    size_t scanRows = count + archivedRows;
+    size_t workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = std::min({workerCount, taskCount, 1 + scanRows / PARALLEL_SCAN_ROWS});
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t task = next++; task < taskCount; task = next++) {
+            PartCollector part(parts[task], less, query.top);
+            if (task < shardCount) scanShard(shards[task], part);
+            else scanArchive((task - shardCount) * ARCHIVE_CHUNK, part);
+            part.finish();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < workerCount; ++i) workers.emplace_back(worker);
+    worker();
+    for (auto& t : workers) t.join();
+
+    // k-way merge of the sorted parts, stopping once top rows are out
+    size_t total = 0;
+    for (const auto& part : parts) total += part.size();
+    size_t limit = query.top > 0 ? std::min(query.top, total) : total;
+
+    using Cursor = std::pair<size_t, size_t>; // part, position
+    auto later = [&](const Cursor& a, const Cursor& b) { return less(parts[b.first][b.second], parts[a.first][a.second]); };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> heads(later);
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (!parts[i].empty()) heads.push({i, 0});
+    }
+
+    std::vector<Row> rows;
+    rows.reserve(limit);
+    while (rows.size() < limit) {
+        Cursor head = heads.top();
+        heads.pop();
+        rows.push_back(std::move(parts[head.first][head.second]));
+        if (++head.second < parts[head.first].size()) heads.push(head);
+    }
+    return rows;
+}
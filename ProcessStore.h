@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Process.h"
+#include "ProcessArchive.h"
+
+// Process table split into shards by name hash. Each shard has its own lock so the generator,
+// forked children and the CLI don't all queue on one mutex. Queries scan the shards (and the
+// archive) on extra threads once there are enough rows to split, then merge the per-shard results.
+class ProcessStore {
+public:
+    // One listed process, either live or archived.
+    struct Row {
+        int pid;
+        std::string_view name; // kept alive by process, or by the archive for archived rows
+        int coreID;
+        Process::ProcessState state;
+        int commandCounter;
+        int linesOfCode;
+        int64_t finishTime; // seconds since the epoch, FINISHED rows only
+        std::shared_ptr<Process> process; // null for archived rows
+
+        std::string getFinishTimeString() const;
+    };
+
+    enum class SortKey { PID, NAME, PROGRESS };
+
+    struct Query {
+        unsigned states = ALL_STATES; // bit per Process::ProcessState
+        std::optional<int> coreID;
+        std::string namePrefix;
+        SortKey sortBy = SortKey::PID;
+        size_t top = 0; // 0 = every match
+    };
+
+    static constexpr unsigned stateBit(Process::ProcessState state) { return 1u << state; }
+    static constexpr unsigned ALL_STATES = (1u << (Process::FINISHED + 1)) - 1;
+
+    explicit ProcessStore(size_t shardCount = 16);
+
+    void add(const std::shared_ptr<Process>& proc);
+    std::shared_ptr<Process> find(const std::string& name) const;
+    size_t size() const;
+
+    // Moves every finished process into the archive and returns how many moved.
+    size_t evictFinished(ProcessArchive& archive);
+
+    // archive may be null. Rows come back ordered by query.sortBy.
+    std::vector<Row> query(const Query& query, const ProcessArchive* archive) const;
+
+private:
+    static constexpr size_t ARCHIVE_CHUNK = 64 * 1024; // archived rows per scan task
+    static constexpr size_t PARALLEL_SCAN_ROWS = 32 * 1024; // rows each extra scan thread should get
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<Process>> byName;
+        std::vector<std::shared_ptr<Process>> processes; // registration order, reused names included
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    size_t shardCount;
+    std::atomic<size_t> count{0};
+
+    // eviction moves rows between a shard and the archive, queries see it all or not at all
+    mutable std::shared_mutex evictionMutex;
+
+    Shard& shardFor(const std::string& name) const;
+};
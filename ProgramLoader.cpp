@@ -0,0 +1,285 @@
+#include "ProgramLoader.h"
+#include "InstructionsTypes.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Read-only view of a whole file. Mapped on POSIX so the tokenizer reads the page cache directly.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return;
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        opened = true;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0) {
+            opened = true;
+            length = static_cast<size_t>(st.st_size);
+            if (length > 0) {
+                void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED) {
+                    opened = false;
+                    length = 0;
+                } else {
+                    mapped = static_cast<const char*>(p);
+                    ::madvise(p, length, MADV_SEQUENTIAL);
+                }
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (mapped) ::munmap(const_cast<char*>(mapped), length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+
+    std::string_view text() const {
+#ifdef _WIN32
+        return buffer;
+#else
+        return std::string_view(mapped, length);
+#endif
+    }
+
+private:
+    bool opened = false;
+#ifdef _WIN32
+    std::string buffer;
+#else
+    const char* mapped = nullptr;
+    size_t length = 0;
+#endif
+};
+
+bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == ',' || c == '(' || c == ')';
+}
+
+// Splits off the next token of a line, skipping spaces, commas and parentheses.
+std::string_view nextToken(std::string_view& line) {
+    size_t start = 0;
+    while (start < line.size() && isSeparator(line[start])) ++start;
+    size_t end = start;
+    while (end < line.size() && !isSeparator(line[end])) ++end;
+    std::string_view token = line.substr(start, end - start);
+    line.remove_prefix(end);
+    return token;
+}
+
+template <typename T>
+bool parseNumber(std::string_view token, T& value) {
+    unsigned long parsed = 0;
+    auto result = std::from_chars(token.data(), token.data() + token.size(), parsed);
+    if (result.ec != std::errc() || result.ptr != token.data() + token.size()) return false;
+    value = static_cast<T>(std::min<unsigned long>(parsed, std::numeric_limits<T>::max()));
+    return true;
+}
+
+// Interns a variable name ahead of building the instruction, false once the table is full.
+bool internVariable(std::string_view name) {
+    return SymbolTable::getInstance().intern(std::string(name)) != SymbolTable::FULL;
+}
+
+// ADD/SUBTRACT read op2 as a number when std::stoi accepts it, otherwise as a variable.
+bool isNumericOperand(std::string_view token) {
+    std::string text(token);
+    char* end = nullptr;
+    std::strtol(text.c_str(), &end, 10);
+    return end != text.c_str();
+}
+
+std::string_view printMessage(std::string_view rest) {
+    size_t open = rest.find('"');
+    size_t close = rest.rfind('"');
+    if (open != std::string_view::npos && close > open) {
+        return rest.substr(open + 1, close - open - 1);
+    }
+    while (!rest.empty() && isSeparator(rest.front())) rest.remove_prefix(1);
+    while (!rest.empty() && isSeparator(rest.back())) rest.remove_suffix(1);
+    return rest;
+}
+
+} // namespace
+
+bool ProgramLoader::parseText(std::string_view text, Program& out, std::string& error) {
+    static const std::string SYMBOLS_FULL = "too many distinct variable names across all programs";
+    struct ForBlock { size_t start; unsigned repeats; int line; };
+    std::vector<ForBlock> forStack;
+
+    int lineNo = 0;
+    while (!text.empty()) {
+        size_t eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+        ++lineNo;
+
+        std::string_view rest = line;
+        std::string_view op = nextToken(rest);
+        if (op.empty() || op.front() == '#') continue;
+
+        auto fail = [&](const std::string& msg) {
+            error = "line " + std::to_string(lineNo) + ": " + msg;
+            return false;
+        };
+
+        if (op == "PRINT") {
+            out.push_back(std::make_shared<PrintInstruction>(std::string(printMessage(rest))));
+        } else if (op == "DECLARE") {
+            std::string_view var = nextToken(rest);
+            uint16_t value = 0;
+            if (var.empty() || !parseNumber(nextToken(rest), value)) return fail("expected DECLARE <var> <value>");
+            if (!internVariable(var)) return fail(SYMBOLS_FULL);
+            out.push_back(std::make_shared<DeclareInstruction>(std::string(var), value));
+        } else if (op == "ADD" || op == "SUBTRACT") {
+            std::string_view dest = nextToken(rest);
+            std::string_view op1 = nextToken(rest);
+            std::string_view op2 = nextToken(rest);
+            if (op2.empty()) return fail("expected " + std::string(op) + " <dest> <op1> <op2>");
+            if (!internVariable(dest) || !internVariable(op1) || (!isNumericOperand(op2) && !internVariable(op2))) {
+                return fail(SYMBOLS_FULL);
+            }
+            if (op == "ADD")
+                out.push_back(std::make_shared<AddInstruction>(std::string(dest), std::string(op1), std::string(op2)));
+            else
+                out.push_back(std::make_shared<SubtractInstruction>(std::string(dest), std::string(op1), std::string(op2)));
+        } else if (op == "SLEEP") {
+            uint8_t ticks = 0;
+            if (!parseNumber(nextToken(rest), ticks)) return fail("expected SLEEP <ticks>");
+            out.push_back(std::make_shared<SleepInstruction>(ticks));
+        } else if (op == "FORK") {
+            out.push_back(std::make_shared<ForkInstruction>(1));
+        } else if (op == "SPAWN") {
+            unsigned children = 0;
+            if (!parseNumber(nextToken(rest), children) || children == 0) return fail("expected SPAWN <children>");
+            out.push_back(std::make_shared<ForkInstruction>(static_cast<int>(children)));
+        } else if (op == "WAIT") {
+            out.push_back(std::make_shared<WaitInstruction>());
+        } else if (op == "FOR") {
+            unsigned repeats = 0;
+            if (!parseNumber(nextToken(rest), repeats)) return fail("expected FOR <repeats>");
+            if (static_cast<int>(forStack.size()) >= MAX_FOR_DEPTH) return fail("FOR nested too deep");
+            forStack.push_back({out.size(), repeats, lineNo});
+        } else if (op == "END") {
+            if (forStack.empty()) return fail("END without FOR");
+            ForBlock block = forStack.back();
+            forStack.pop_back();
+
+            // unroll by repeating the body's pointers, the instruction objects themselves are shared
+            size_t bodySize = out.size() - block.start;
+            if (block.repeats == 0) {
+                out.resize(block.start);
+            } else if (bodySize * block.repeats > MAX_PROGRAM_SIZE - block.start) {
+                return fail("program too large after unrolling FOR");
+            } else {
+                out.reserve(block.start + bodySize * block.repeats);
+                for (unsigned r = 1; r < block.repeats; ++r) {
+                    for (size_t i = 0; i < bodySize; ++i) out.push_back(out[block.start + i]);
+                }
+            }
+        } else {
+            return fail("unknown instruction " + std::string(op));
+        }
+
+        if (out.size() > MAX_PROGRAM_SIZE) return fail("program too large");
+    }
+
+    if (!forStack.empty()) {
+        error = "line " + std::to_string(forStack.back().line) + ": FOR without END";
+        return false;
+    }
+    return true;
+}
+
+bool ProgramLoader::parseFile(const std::string& path, Program& out, std::string& error) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        error = "cannot open " + path;
+        return false;
+    }
+    if (!parseText(file.text(), out, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+std::vector<ProgramLoader::LoadedProgram> ProgramLoader::loadDirectory(const std::string& dir, std::string& error) {
+    namespace fs = std::filesystem;
+    std::vector<LoadedProgram> programs;
+
+    std::error_code ec;
+    fs::directory_iterator it(dir, ec);
+    if (ec) {
+        error = "cannot open directory " + dir + ": " + ec.message();
+        return programs;
+    }
+    for (const auto& entry : it) {
+        if (!entry.is_regular_file(ec)) continue;
+        LoadedProgram program;
+        program.path = entry.path().string();
+        program.name = entry.path().stem().string();
+        programs.push_back(std::move(program));
+    }
+    std::sort(programs.begin(), programs.end(),
+              [](const LoadedProgram& a, const LoadedProgram& b) { return a.path < b.path; });
+
+    size_t workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = std::min(workerCount, programs.size());
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < programs.size(); i = next++) {
+            auto& program = programs[i];
+            // an exception escaping a worker thread would terminate the emulator, report it as this file's error
+            bool parsed = false;
+            try {
+                parsed = parseFile(program.path, program.instructions, program.error);
+            } catch (const std::exception& e) {
+                program.error = program.path + ": " + e.what();
+            } catch (...) {
+                program.error = program.path + ": unknown error";
+            }
+            if (!parsed) {
+                program.instructions.clear();
+                program.instructions.shrink_to_fit();
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < workerCount; ++i) workers.emplace_back(worker);
+    worker();
+    for (auto& t : workers) t.join();
+
+    return programs;
+}
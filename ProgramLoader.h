@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include "Instruction.h"
+
+// Builds process programs from text files, one instruction per line:
+//   DECLARE x 5 | ADD x x 1 | SUBTRACT x x y | PRINT "msg" | SLEEP 3
+//   FOR 3 ... END   (up to 3 levels deep, unrolled while parsing)
+//   FORK | SPAWN 100 | WAIT   (children continue after the FORK/SPAWN line, WAIT blocks until they finish)
+// Blank lines and lines starting with '#' are skipped.
+class ProgramLoader {
+public:
+    using Program = std::vector<std::shared_ptr<Instruction>>;
+
+    struct LoadedProgram {
+        std::string name;  // file name without extension, used as the process name
+        std::string path;
+        Program instructions;
+        std::string error; // empty if the file parsed
+    };
+
+    static constexpr int MAX_FOR_DEPTH = 3;
+    static constexpr size_t MAX_PROGRAM_SIZE = 1 << 20; // after unrolling FOR blocks
+
+    static bool parseText(std::string_view text, Program& out, std::string& error);
+    static bool parseFile(const std::string& path, Program& out, std::string& error);
+
+    // Parses every regular file in dir, spread over the hardware threads. Results are in file name order.
+    static std::vector<LoadedProgram> loadDirectory(const std::string& dir, std::string& error);
+};
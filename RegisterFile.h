@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "SymbolTable.h"
+
+// Fixed-size variable storage for one process, keyed by SymbolTable ids.
+// Holds at most CAPACITY variables (the spec's 64-byte symbol table = 32 uint16 slots).
+// Once full, writes to new variables are ignored and reads of unknown variables give 0,
+// so memory per process is bounded and nothing is allocated while executing.
+class RegisterFile {
+public:
+    static constexpr int CAPACITY = 32;
+
+    uint16_t get(uint16_t symbol) const {
+        int slot = find(symbol);
+        return slot >= 0 ? values[slot] : 0;
+    }
+
+    // Returns false when the variable is new and every slot is taken.
+    bool set(uint16_t symbol, uint16_t value) {
+        if (symbol == SymbolTable::FULL) return false;
+        int slot = find(symbol);
+        if (slot < 0) {
+            if (count >= CAPACITY) return false;
+            slot = count++;
+            symbols[slot] = symbol;
+        }
+        values[slot] = value;
+        return true;
+    }
+
+    bool contains(uint16_t symbol) const { return find(symbol) >= 0; }
+    int size() const { return count; }
+    bool isFull() const { return count >= CAPACITY; }
+
+private:
+    std::array<uint16_t, CAPACITY> symbols{};
+    std::array<uint16_t, CAPACITY> values{};
+    uint8_t count = 0;
+
+    int find(uint16_t symbol) const {
+        for (int i = 0; i < count; ++i) {
+            if (symbols[i] == symbol) return i;
+        }
+        return -1;
+    }
+};
@@ -5,84 +5,459 @@
 Scheduler::Scheduler(int numCores, const std::string& algorithm, int quantum, int delay)
     : numCores(numCores), schedulingAlgorithm(algorithm), quantum(quantum), isRunning(true), delayPerExec(delay){
     cores.resize(numCores);
+    selectEngine();
 }
 
 void Scheduler::addProcess(std::shared_ptr<Process> process) {
     process->setState(Process::READY);
-    readyQueue.push(process);
+    enqueueReady(std::move(process));
+
+    // pairs with the fence in waitForWork: either we see the loop parked, or it sees our process
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waitingForWork.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        workAvailable.notify_one();
+    }
+}
+
+void Scheduler::enqueueReady(std::shared_ptr<Process> process) {
+    if (overflowCount.load(std::memory_order_acquire) == 0 && readyQueue.tryPush(process)) return;
+
+    std::lock_guard<std::mutex> lock(overflowMutex);
+    overflowQueue.push_back(std::move(process));
+    overflowCount.fetch_add(1, std::memory_order_release);
+}
+
+bool Scheduler::dequeueReady(std::shared_ptr<Process>& process) {
+    if (readyQueue.tryPop(process)) return true;
+    if (overflowCount.load(std::memory_order_acquire) == 0) return false;
+
+    std::lock_guard<std::mutex> lock(overflowMutex);
+    if (overflowQueue.empty()) return false;
+    process = std::move(overflowQueue.front());
+    overflowQueue.pop_front();
+    overflowCount.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+size_t Scheduler::getReadyQueueSize() const {
+    return readyQueue.sizeApprox() + overflowCount.load(std::memory_order_acquire);
+}
+
+bool Scheduler::addGroup(std::shared_ptr<ProcessGroup> group) {
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        if (group->getRunnableCount() > numCores) return false;
+        for (const auto& member : group->getMembers()) {
+            if (!member->isFinished()) member->setState(Process::READY);
+        }
+        group->setQueuedTick(tickCount);
+        groupQueue[group->getPriority()].push_back(group);
+    }
+    workAvailable.notify_one();
+    return true;
 }
 
 void Scheduler::tick() {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
     if (!isRunning) return;
     assignProcessesToCores();
-    executeProcesses();
+    (this->*executeFn)();
+    advanceGroups();
+    tickCount++;
+}
+
+void Scheduler::traceEvent(int coreID, const std::shared_ptr<Process>& process, TraceEvent event) {
+#ifndef CSOPESY_NO_TRACE
+    if (trace.isEnabled()) trace.record(tickCount, coreID, process->getPID(), event);
+#endif
+}
+
+bool Scheduler::hasWork() const {
+    if (getReadyQueueSize() > 0 || !groupQueue.empty()) return true;
+    for (const auto& core : cores) {
+        // a finished process still on a core needs one more tick to be cleared
+        if (core.currentProcess) return true;
+    }
+    return false;
+}
+
+bool Scheduler::waitForWork() {
+    std::unique_lock<std::mutex> lock(schedulerMutex);
+    waitingForWork.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    workAvailable.wait(lock, [this]() { return !isRunning || hasWork(); });
+    waitingForWork.store(false, std::memory_order_relaxed);
+    return isRunning;
+}
+
+bool Scheduler::waitForNextTick(std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lock(schedulerMutex);
+    workAvailable.wait_for(lock, interval, [this]() { return !isRunning; });
+    return isRunning;
 }
 
 void Scheduler::assignProcessesToCores() {
-    for (int i = 0; i < numCores; ++i) {
+    // collected highest core first so pop_back hands out the lowest free core
+    freeCores.clear();
+    for (int i = numCores - 1; i >= 0; --i) {
         auto& core = cores[i];
-        if (!core.currentProcess || core.currentProcess->isFinished()) {
-            if (core.currentProcess && core.currentProcess->isFinished()) {
-                core.currentProcess->setState(Process::FINISHED);
-                core.currentProcess = nullptr;
+        if (core.group) continue; // held until the whole gang finishes or is preempted
+        if (core.currentProcess && core.currentProcess->isFinished()) {
+            core.currentProcess->setState(Process::FINISHED);
+            core.currentProcess = nullptr;
+        }
+        if (!core.currentProcess) freeCores.push_back(i);
+    }
+
+    dispatchGroups();
+    if (holdingCores) return;
+
+    std::shared_ptr<Process> nextProcess;
+    while (!freeCores.empty() && dequeueReady(nextProcess)) {
+        int i = freeCores.back();
+        freeCores.pop_back();
+        auto& core = cores[i];
+
+        nextProcess->setCoreID(i);
+        nextProcess->setState(Process::RUNNING);
+        traceEvent(i, nextProcess, TraceEvent::DISPATCH);
+        core.currentProcess = std::move(nextProcess);
+        core.remainingQuantum = quantum;
+    }
+}
+
+// Gangs go first, by priority. A gang is only dispatched if all its unfinished members fit
+// in the free cores; ones that don't fit stay queued and singles backfill the cores, until
+// the gang has waited GANG_BACKFILL_TICKS. From then on free cores are held for it.
+void Scheduler::dispatchGroups() {
+    holdingCores = false;
+    for (auto level = groupQueue.begin(); level != groupQueue.end() && !freeCores.empty();) {
+        auto& queue = level->second;
+        for (auto it = queue.begin(); it != queue.end() && !freeCores.empty();) {
+            auto group = *it;
+            int needed = group->getRunnableCount();
+            if (needed > static_cast<int>(freeCores.size())) {
+                if (needed <= numCores && tickCount - group->getQueuedTick() >= GANG_BACKFILL_TICKS) {
+                    holdingCores = true;
+                    return;
+                }
+                ++it;
+                continue;
             }
+            it = queue.erase(it);
+            if (needed == 0) continue;
 
-            if (!readyQueue.empty()) {
-                auto nextProcess = readyQueue.front();
-                readyQueue.pop();
-                nextProcess->setCoreID(i);
-                nextProcess->setState(Process::RUNNING);
-                core.currentProcess = nextProcess;
-                core.remainingQuantum = quantum;
+            const auto& members = group->getMembers();
+            for (size_t m = 0; m < members.size(); ++m) {
+                if (members[m]->isFinished()) continue;
+                int i = freeCores.back();
+                freeCores.pop_back();
+                cores[i].currentProcess = members[m];
+                cores[i].group = group;
+                members[m]->setCoreID(i);
+                members[m]->setState(Process::RUNNING);
+                group->setMemberCore(m, i);
+                traceEvent(i, members[m], TraceEvent::DISPATCH);
             }
+            group->setRemainingQuantum(groupQuantum(group));
+            group->recordDispatch();
+            runningGroups.push_back(group);
         }
+        if (queue.empty()) level = groupQueue.erase(level);
+        else ++level;
+    }
+}
+
+// -1 means the gang keeps its cores until every member finishes
+int Scheduler::groupQuantum(const std::shared_ptr<ProcessGroup>& group) const {
+    if (group->getQuantum() > 0) return group->getQuantum();
+    return preemptive ? quantum : -1;
+}
+
+// caller holds schedulerMutex (or is the constructor)
+void Scheduler::selectEngine() {
+    preemptive = schedulingAlgorithm == "rr";
+    executeFn = preemptive ? engineFor<RoundRobin>() : engineFor<Fcfs>();
+}
+
+template <typename Policy>
+Scheduler::ExecuteFn Scheduler::engineFor() const {
+    if (!fixedCoreEngines) return &Scheduler::executeProcesses<Policy, 0>;
+    switch (numCores) {
+        case 1: return &Scheduler::executeProcesses<Policy, 1>;
+        case 4: return &Scheduler::executeProcesses<Policy, 4>;
+        case 8: return &Scheduler::executeProcesses<Policy, 8>;
+        case 16: return &Scheduler::executeProcesses<Policy, 16>;
+        case 64: return &Scheduler::executeProcesses<Policy, 64>;
+        default: return &Scheduler::executeProcesses<Policy, 0>;
     }
 }
 
+template <typename Policy, int FixedCores>
 void Scheduler::executeProcesses() {
-    for (int i = 0; i < numCores; ++i) {
-        auto& core = cores[i];
-        if (core.currentProcess && !core.currentProcess->isFinished()) {
-            core.currentProcess->executeNextInstruction(i);
+    for (const auto& group : runningGroups) {
+        int finished = group->getFinishedCount();
+        group->recordTick(group->getMemberCount() - finished, finished);
+    }
 
-            if(delayPerExec > 0){
-                volatile uint64_t busy = 0;
-                for (int j = 0; j < delayPerExec; ++j){
-                    busy += j;
-                }
+    const int coreCount = FixedCores > 0 ? FixedCores : numCores;
+    for (int i = 0; i < coreCount; ++i) {
+        executeCore<Policy>(i);
+    }
+}
 
-            }
+template <typename Policy>
+inline void Scheduler::executeCore(int i) {
+    auto& core = cores[i];
+    if (!core.currentProcess || core.currentProcess->isFinished()) return;
+
+    bool wasSleeping = core.currentProcess->isSleeping();
+    core.currentProcess->executeNextInstruction(i);
+    if (spawnHandler) spawnChildren(core.currentProcess);
+
+    if (core.currentProcess->isFinished()) {
+        traceEvent(i, core.currentProcess, TraceEvent::FINISH);
+        onProcessFinished(core.currentProcess);
+    } else if (core.currentProcess->getState() == Process::WAITING) {
+        if (core.group) {
+            // gang members keep their core and retry the WAIT each tick
+            core.currentProcess->setState(Process::RUNNING);
+        } else {
+            // off the core until onProcessFinished requeues it
+            traceEvent(i, core.currentProcess, TraceEvent::WAIT);
+            core.currentProcess = nullptr;
+            return;
+        }
+    } else if (wasSleeping != core.currentProcess->isSleeping()) {
+        traceEvent(i, core.currentProcess, wasSleeping ? TraceEvent::WAKE : TraceEvent::SLEEP);
+    }
+
+    if(delayPerExec > 0){
+        volatile uint64_t busy = 0;
+        for (int j = 0; j < delayPerExec; ++j){
+            busy += j;
+        }
+
+    }
+
+    if constexpr (Policy::PREEMPTIVE) {
+        if (core.group) return;
+        core.remainingQuantum--;
+
+        if (core.remainingQuantum <= 0 && !core.currentProcess->isFinished()) {
+            // Preempt and requeue
+            traceEvent(i, core.currentProcess, TraceEvent::PREEMPT);
+            core.currentProcess->setState(Process::READY);
+            enqueueReady(core.currentProcess);
+            core.currentProcess = nullptr;
+        }
+    }
+}
 
-            if (schedulingAlgorithm == "rr") {
-                core.remainingQuantum--;
+void Scheduler::spawnChildren(const std::shared_ptr<Process>& parent) {
+    for (int n = parent->takePendingForks(); n > 0; --n) {
+        auto child = spawnHandler(parent);
+        if (!child) break;
+        if (child->isFinished()) {
+            onProcessFinished(child);
+        } else {
+            child->setState(Process::READY);
+            enqueueReady(std::move(child));
+        }
+    }
+}
 
-                if (core.remainingQuantum <= 0 && !core.currentProcess->isFinished()) {
-                    // Preempt and requeue
+// Lets the finish handler account for the process, then requeues a parent blocked on WAIT
+// once its last child finishes.
+void Scheduler::onProcessFinished(const std::shared_ptr<Process>& process) {
+    if (finishHandler) finishHandler(process);
+
+    auto parent = process->getParent();
+    if (parent && parent->getState() == Process::WAITING && parent->getLiveChildren() == 0) {
+        parent->setState(Process::READY);
+        enqueueReady(std::move(parent));
+    }
+}
+
+void Scheduler::advanceGroups() {
+    for (size_t g = 0; g < runningGroups.size();) {
+        auto group = runningGroups[g];
+        int remaining = group->getRemainingQuantum();
+        bool expired = false;
+        if (!group->isFinished() && remaining > 0) {
+            group->setRemainingQuantum(--remaining);
+            expired = remaining == 0;
+        }
+
+        if (!group->isFinished() && !expired) {
+            ++g;
+            continue;
+        }
+
+        runningGroups[g] = runningGroups.back();
+        runningGroups.pop_back();
+        if (expired) {
+            preemptGroup(group);
+        } else {
+            releaseGroup(group);
+        }
+    }
+}
+
+// Takes the whole gang off its cores and requeues it. Caller removes it from runningGroups.
+void Scheduler::preemptGroup(const std::shared_ptr<ProcessGroup>& group) {
+    releaseGroup(group);
+    group->recordPreemption();
+    group->setQueuedTick(tickCount);
+    groupQueue[group->getPriority()].push_back(group);
+}
+
+void Scheduler::releaseGroup(const std::shared_ptr<ProcessGroup>& group) {
+    const auto& members = group->getMembers();
+    for (size_t m = 0; m < members.size(); ++m) {
+        int i = group->getMemberCore(m);
+        if (i < 0) continue;
+        cores[i].currentProcess = nullptr;
+        cores[i].group = nullptr;
+        group->setMemberCore(m, -1);
+        if (!members[m]->isFinished()) traceEvent(i, members[m], TraceEvent::PREEMPT);
+        members[m]->setState(members[m]->isFinished() ? Process::FINISHED : Process::READY);
+    }
+}
+
+std::vector<std::shared_ptr<ProcessGroup>> Scheduler::reconfigure(int newNumCores, const std::string& algorithm, int newQuantum, int delay) {
+    std::vector<std::shared_ptr<ProcessGroup>> split;
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        if (newNumCores < 1) newNumCores = 1;
+
+        for (int i = newNumCores; i < numCores; ++i) {
+            auto& core = cores[i];
+            if (core.group) {
+                auto group = core.group;
+                for (size_t g = 0; g < runningGroups.size(); ++g) {
+                    if (runningGroups[g] == group) {
+                        runningGroups[g] = runningGroups.back();
+                        runningGroups.pop_back();
+                        break;
+                    }
+                }
+                preemptGroup(group); // also frees the gang's cores that are being kept
+            } else if (core.currentProcess) {
+                if (core.currentProcess->isFinished()) {
+                    core.currentProcess->setState(Process::FINISHED);
+                } else {
+                    traceEvent(i, core.currentProcess, TraceEvent::PREEMPT);
                     core.currentProcess->setState(Process::READY);
-                    readyQueue.push(core.currentProcess);
-                    core.currentProcess = nullptr;
+                    enqueueReady(core.currentProcess);
                 }
+                core.currentProcess = nullptr;
             }
         }
+
+        cores.resize(newNumCores);
+        numCores = newNumCores;
+        if (trace.isEnabled()) trace.resize(newNumCores);
+        schedulingAlgorithm = algorithm;
+        quantum = newQuantum;
+        delayPerExec = delay;
+        selectEngine();
+        for (auto& core : cores) {
+            if (core.remainingQuantum > quantum) core.remainingQuantum = quantum;
+        }
+        split = splitOversizedGroups();
     }
+    workAvailable.notify_all();
+    return split;
+}
+
+// After the core count shrinks, a queued gang with more unfinished members than cores could
+// never be dispatched again. Its members run as ordinary processes instead. Caller holds schedulerMutex.
+std::vector<std::shared_ptr<ProcessGroup>> Scheduler::splitOversizedGroups() {
+    std::vector<std::shared_ptr<ProcessGroup>> split;
+    for (auto level = groupQueue.begin(); level != groupQueue.end();) {
+        auto& queue = level->second;
+        for (auto it = queue.begin(); it != queue.end();) {
+            if ((*it)->getRunnableCount() <= numCores) {
+                ++it;
+                continue;
+            }
+            for (const auto& member : (*it)->getMembers()) {
+                if (member->isFinished()) continue;
+                member->setState(Process::READY);
+                enqueueReady(member);
+            }
+            split.push_back(*it);
+            it = queue.erase(it);
+        }
+        if (queue.empty()) level = groupQueue.erase(level);
+        else ++level;
+    }
+    return split;
 }
 
 void Scheduler::stop() {
-    isRunning = false;
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        isRunning = false;
+    }
+    workAvailable.notify_all();
 }
 
 void Scheduler::resume() {
-    isRunning = true;
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        isRunning = true;
+    }
+    workAvailable.notify_all();
+}
+
+bool Scheduler::startTrace(const std::string& path, uint32_t tickMicros) {
+#ifdef CSOPESY_NO_TRACE
+    return false; // no hooks would record into it
+#else
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    return trace.open(path, numCores, tickMicros);
+#endif
+}
+
+void Scheduler::stopTrace() {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    trace.close();
+}
+
+bool Scheduler::isTracing() const {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    return trace.isEnabled();
+}
+
+void Scheduler::setSpawnHandler(SpawnHandler handler) {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    spawnHandler = std::move(handler);
+}
+
+void Scheduler::setFinishHandler(FinishHandler handler) {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    finishHandler = std::move(handler);
+}
+
+void Scheduler::setFixedCoreEngines(bool enabled) {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+    fixedCoreEngines = enabled;
+    selectEngine();
 }
 
 std::string Scheduler::getAlgorithm() const {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
     return schedulingAlgorithm;
 }
 
 int Scheduler::getAvailableCores() const {
+    std::lock_guard<std::mutex> lock(schedulerMutex);
     int count = 0;
     for (const auto& core : cores) {
-        if (!core.currentProcess || core.currentProcess->isFinished()) {
+        if (!core.group && (!core.currentProcess || core.currentProcess->isFinished())) {
             count++;
         }
     }
@@ -1,23 +1,62 @@
 #pragma once
 
 #include <vector>
-#include <queue>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <map>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
 #include "Process.h"
+#include "ProcessGroup.h"
+#include "MPMCQueue.h"
+#include "TraceRecorder.h"
 
 class Scheduler {
 public:
     Scheduler(int numCores, const std::string& algorithm, int quantum = 1, int delay = 0);
 
     void addProcess(std::shared_ptr<Process> process);
+    // Queues a gang. Returns false if it has more unfinished members than there are cores.
+    bool addGroup(std::shared_ptr<ProcessGroup> group);
     void tick(); // Simulates one CPU cycle
     void stop(); // Stops the scheduler loop
     void resume(); // Resumes the scheduler loop
+    // Applies new settings without dropping work. Processes on removed cores go back to the
+    // ready queue and gangs holding a removed core are preempted. Queued gangs that no longer
+    // fit in the new core count are split, their members queued as single processes; those
+    // gangs are returned so the caller can report them.
+    std::vector<std::shared_ptr<ProcessGroup>> reconfigure(int numCores, const std::string& algorithm, int quantum, int delay);
+
+    // Blocks until there is something to run (ready or on a core) or the scheduler is stopped.
+    // Returns false once stopped so the caller can leave its loop.
+    bool waitForWork();
+    // Sleeps for one tick interval but wakes early on stop(). Returns false once stopped.
+    bool waitForNextTick(std::chrono::milliseconds interval);
+
+    // Records dispatch/preempt/sleep/wake/finish events per core into a binary trace file.
+    bool startTrace(const std::string& path, uint32_t tickMicros);
+    void stopTrace();
+    bool isTracing() const;
+
+    // Called on the scheduler thread for each child a FORK/SPAWN asks for. It should create the
+    // child with parent->fork() (assigning the pid and registering it) and return it, or nullptr.
+    using SpawnHandler = std::function<std::shared_ptr<Process>(const std::shared_ptr<Process>& parent)>;
+    void setSpawnHandler(SpawnHandler handler);
+    // Called on the scheduler thread when a process executes its last instruction.
+    using FinishHandler = std::function<void(const std::shared_ptr<Process>& process)>;
+    void setFinishHandler(FinishHandler handler);
+
+    // On by default. Off forces the generic numCores loop, so bench_scheduler can compare the two.
+    void setFixedCoreEngines(bool enabled);
 
     std::string getAlgorithm() const;
     int getAvailableCores() const;
+    size_t getReadyQueueSize() const; // approximate while other threads are adding
 
 private:
     int numCores;
@@ -25,16 +64,70 @@ private:
     int quantum;
     int delayPerExec = 0;
 
+    // The execute loop is instantiated per policy and for common core counts so the per-core
+    // body has no algorithm check and a fixed-count loop can be unrolled. selectEngine() picks
+    // the instantiation whenever the algorithm or core count changes.
+    struct Fcfs { static constexpr bool PREEMPTIVE = false; };
+    struct RoundRobin { static constexpr bool PREEMPTIVE = true; };
+    using ExecuteFn = void (Scheduler::*)();
+    ExecuteFn executeFn = nullptr;
+    bool preemptive = false; // the selected policy's, for gang quanta
+    bool fixedCoreEngines = true;
+
     struct Core {
         std::shared_ptr<Process> currentProcess = nullptr;
         int remainingQuantum = 0;
+        std::shared_ptr<ProcessGroup> group = nullptr; // set while the core is held by a dispatched gang
     };
 
     std::vector<Core> cores;
-    std::queue<std::shared_ptr<Process>> readyQueue;
+
+    // Lock-free so addProcess from the CLI and generator threads never waits on a tick.
+    // Arrivals that find the ring full spill into overflowQueue, which is served once the
+    // ring drains; later arrivals also go there while it is non-empty to keep FIFO order.
+    static constexpr size_t READY_QUEUE_CAPACITY = 1 << 12;
+    MPMCQueue<std::shared_ptr<Process>> readyQueue{READY_QUEUE_CAPACITY};
+    std::mutex overflowMutex;
+    std::deque<std::shared_ptr<Process>> overflowQueue;
+    std::atomic<size_t> overflowCount{0};
+    std::map<int, std::deque<std::shared_ptr<ProcessGroup>>, std::greater<int>> groupQueue; // by priority, highest first
+    std::vector<std::shared_ptr<ProcessGroup>> runningGroups;
+    std::vector<int> freeCores; // scratch for assignProcessesToCores
+    // A gang that has waited this many ticks without fitting stops singles (and lower gangs)
+    // from taking freed cores, so it gets in once enough of them free up.
+    static constexpr uint64_t GANG_BACKFILL_TICKS = 8;
+    bool holdingCores = false; // set by dispatchGroups for the current tick
 
     bool isRunning;
+    uint64_t tickCount = 0;
+    TraceRecorder trace;
+    SpawnHandler spawnHandler;
+    FinishHandler finishHandler;
+
+    // guards cores, groupQueue and isRunning (the ready queue has its own synchronization)
+    mutable std::mutex schedulerMutex;
+    std::condition_variable workAvailable;
+    std::atomic<bool> waitingForWork{false}; // addProcess only takes schedulerMutex to wake an idle loop
+
+    void traceEvent(int coreID, const std::shared_ptr<Process>& process, TraceEvent event);
+    void spawnChildren(const std::shared_ptr<Process>& parent);
+    void onProcessFinished(const std::shared_ptr<Process>& process);
+    void enqueueReady(std::shared_ptr<Process> process);
+    bool dequeueReady(std::shared_ptr<Process>& process);
 
+    bool hasWork() const; // caller holds schedulerMutex
     void assignProcessesToCores();
+    void dispatchGroups();
+    void selectEngine();
+    template <typename Policy>
+    ExecuteFn engineFor() const;
+    template <typename Policy, int FixedCores> // FixedCores 0 = use numCores
     void executeProcesses();
+    template <typename Policy>
+    void executeCore(int i);
+    void advanceGroups();
+    void releaseGroup(const std::shared_ptr<ProcessGroup>& group);
+    void preemptGroup(const std::shared_ptr<ProcessGroup>& group);
+    int groupQuantum(const std::shared_ptr<ProcessGroup>& group) const;
+    std::vector<std::shared_ptr<ProcessGroup>> splitOversizedGroups();
 };
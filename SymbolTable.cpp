@@ -0,0 +1,35 @@
+#include "SymbolTable.h"
+#include <mutex>
+
+SymbolTable& SymbolTable::getInstance() {
+    static SymbolTable instance;
+    return instance;
+}
+
+uint16_t SymbolTable::intern(const std::string& name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(tableMutex);
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(tableMutex);
+    auto it = ids.find(name); // another thread may have added it in between
+    if (it != ids.end()) return it->second;
+
+    if (names.size() >= FULL) return FULL;
+    uint16_t id = static_cast<uint16_t>(names.size());
+    names.push_back(name);
+    ids.emplace(name, id);
+    return id;
+}
+
+std::string SymbolTable::nameOf(uint16_t id) const {
+    std::shared_lock<std::shared_mutex> lock(tableMutex);
+    return id < names.size() ? names[id] : std::string();
+}
+
+size_t SymbolTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(tableMutex);
+    return names.size();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstdint>
+
+// Global interner for variable names. Instructions resolve their names to small ids
+// once when they are built, so executing them never hashes or allocates strings.
+class SymbolTable {
+public:
+    static SymbolTable& getInstance();
+
+    // Returned by intern() once every id is taken. The table is global and never shrinks,
+    // so loaders must check for it; a RegisterFile drops writes to it and reads it as 0.
+    static constexpr uint16_t FULL = 0xFFFF;
+
+    uint16_t intern(const std::string& name);
+    std::string nameOf(uint16_t id) const;
+    size_t size() const;
+
+private:
+    SymbolTable() = default;
+
+    mutable std::shared_mutex tableMutex; // programs can be built from several threads
+    std::unordered_map<std::string, uint16_t> ids;
+    std::vector<std::string> names;
+};
@@ -0,0 +1,50 @@
+#include "TraceRecorder.h"
+#include <cstring>
+
+TraceRecorder::~TraceRecorder() {
+    close();
+}
+
+bool TraceRecorder::open(const std::string& path, int numCores, uint32_t tickMicros) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    TraceFileHeader header;
+    std::memcpy(header.magic, "CSTR", 4);
+    header.version = VERSION;
+    header.numCores = static_cast<uint32_t>(numCores);
+    header.tickMicros = tickMicros;
+    std::fwrite(&header, sizeof(header), 1, file);
+
+    resize(numCores);
+    return true;
+}
+
+void TraceRecorder::close() {
+    if (!file) return;
+    for (size_t core = 0; core < buffers.size(); ++core) {
+        flush(static_cast<int>(core));
+    }
+    std::fclose(file);
+    file = nullptr;
+}
+
+void TraceRecorder::resize(int numCores) {
+    if (numCores < 0) numCores = 0;
+    for (size_t core = numCores; core < buffers.size(); ++core) {
+        flush(static_cast<int>(core));
+    }
+    buffers.resize(numCores);
+    for (auto& buffer : buffers) {
+        buffer.reserve(BUFFER_RECORDS);
+    }
+}
+
+void TraceRecorder::flush(int core) {
+    auto& buffer = buffers[core];
+    if (file && !buffer.empty()) {
+        std::fwrite(buffer.data(), sizeof(TraceRecord), buffer.size(), file);
+    }
+    buffer.clear();
+}
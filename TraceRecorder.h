@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Binary scheduler trace. Build with -DCSOPESY_NO_TRACE to compile the hooks out completely;
+// otherwise a disabled recorder costs one branch per event.
+//
+// File layout: TraceFileHeader followed by TraceRecords. Records are written one core
+// buffer at a time, so they are only ordered by tick within a core (trace2json sorts them).
+
+enum class TraceEvent : uint8_t {
+    DISPATCH, // process put on a core
+    PREEMPT,  // taken off a core before finishing
+    SLEEP,    // executed a SLEEP instruction
+    WAKE,     // sleep ran out
+    FINISH,   // executed its last instruction
+    WAIT      // blocked on WAIT and gave up its core
+};
+
+struct TraceFileHeader {
+    char magic[4];       // "CSTR"
+    uint32_t version;
+    uint32_t numCores;   // at the time tracing started
+    uint32_t tickMicros; // wall time of one tick, for the timeline
+};
+
+struct TraceRecord {
+    uint64_t tick;
+    uint32_t pid;
+    uint16_t core;
+    uint8_t event; // TraceEvent
+    uint8_t reserved;
+};
+
+static_assert(sizeof(TraceRecord) == 16, "trace records are written as raw 16-byte structs");
+
+class TraceRecorder {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t BUFFER_RECORDS = 4096; // per core, flushed to the file when full
+
+    ~TraceRecorder();
+
+    bool open(const std::string& path, int numCores, uint32_t tickMicros);
+    void close(); // flushes every core buffer
+    bool isEnabled() const { return file != nullptr; }
+    void resize(int numCores);
+
+    // Only called from the scheduler thread, so the per-core buffers need no locking.
+    void record(uint64_t tick, int core, int pid, TraceEvent event) {
+        if (core < 0 || core >= static_cast<int>(buffers.size())) return;
+        auto& buffer = buffers[core];
+        buffer.push_back({tick, static_cast<uint32_t>(pid), static_cast<uint16_t>(core), static_cast<uint8_t>(event), 0});
+        if (buffer.size() == BUFFER_RECORDS) flush(core);
+    }
+
+private:
+    std::FILE* file = nullptr;
+    std::vector<std::vector<TraceRecord>> buffers;
+
+    void flush(int core);
+};
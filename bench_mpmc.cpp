@@ -0,0 +1,135 @@
+// bench_mpmc.cpp - enqueue/dequeue throughput of the scheduler's ready queue (MPMCQueue)
+// with 1..N producer threads feeding consumer threads, next to a mutex-guarded deque
+// (what the ready queue used to be) as the baseline.
+//
+// Compile using: g++ -std=c++17 -O2 -pthread -o bench_mpmc.exe bench_mpmc.cpp
+// Run using    : bench_mpmc.exe [max producers] [consumers] [items per producer]
+
+#include "MPMCQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// What the queues carry in the emulator.
+struct Item {
+    long value;
+};
+using Payload = std::shared_ptr<Item>;
+
+class LockedDeque {
+public:
+    bool tryPush(Payload value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(value));
+        return true;
+    }
+
+    bool tryPop(Payload& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty()) return false;
+        value = std::move(queue.front());
+        queue.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<Payload> queue;
+};
+
+struct Result {
+    double seconds;
+    long long checksum;
+};
+
+// Every producer pushes itemsPerProducer items, consumers pop until all of them are out.
+template <typename Queue>
+Result run(Queue& queue, int producers, int consumers, long itemsPerProducer) {
+    const long long total = static_cast<long long>(producers) * itemsPerProducer;
+    std::atomic<long long> consumed{0};
+    std::atomic<long long> checksum{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (long i = 0; i < itemsPerProducer; ++i) {
+                Payload item = std::make_shared<Item>(Item{p * itemsPerProducer + i});
+                while (!queue.tryPush(item)) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&]() {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            long long sum = 0;
+            Payload item;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (queue.tryPop(item)) {
+                    sum += item->value;
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            checksum += sum;
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return {std::chrono::duration<double>(elapsed).count(), checksum.load()};
+}
+
+void report(const char* name, int producers, long itemsPerProducer, const Result& result) {
+    long long total = static_cast<long long>(producers) * itemsPerProducer;
+    long long expected = total * (total - 1) / 2;
+    std::cout << "  " << std::left << std::setw(14) << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(2) << total / result.seconds / 1e6 << " Mops/s"
+              << (result.checksum == expected ? "" : "  CHECKSUM MISMATCH") << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int maxProducers = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int consumers = argc > 2 ? std::atoi(argv[2]) : 1;
+    long itemsPerProducer = argc > 3 ? std::atol(argv[3]) : 200000;
+    if (maxProducers < 1 || consumers < 1 || itemsPerProducer < 1) {
+        std::cerr << "Usage: bench_mpmc [max producers] [consumers] [items per producer]\n";
+        return 1;
+    }
+
+    std::cout << "Items per producer: " << itemsPerProducer << ", consumers: " << consumers
+              << ", hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    // 1, 2, 4, ... then maxProducers itself when it isn't a power of two
+    std::vector<int> producerCounts;
+    for (int producers = 1; producers < maxProducers; producers *= 2) producerCounts.push_back(producers);
+    producerCounts.push_back(maxProducers);
+
+    for (int producers : producerCounts) {
+        std::cout << producers << " producer(s)\n";
+        {
+            MPMCQueue<Payload> ring(1 << 12); // same capacity as Scheduler's ready queue
+            report("MPMCQueue", producers, itemsPerProducer, run(ring, producers, consumers, itemsPerProducer));
+        }
+        {
+            LockedDeque deque;
+            report("mutex+deque", producers, itemsPerProducer, run(deque, producers, consumers, itemsPerProducer));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+// bench_scheduler.cpp - cost of one Scheduler::tick() with the execute loop specialized for the
+// core count (executeProcesses<Policy, N>) against the generic loop (executeProcesses<Policy, 0>),
+// for fcfs and rr at each core count that has a specialization.
+//
+// Compile using: g++ -std=c++17 -O2 -pthread -o bench_scheduler.exe bench_scheduler.cpp Scheduler.cpp Process.cpp ProcessGroup.cpp TraceRecorder.cpp SymbolTable.cpp
+// Run using    : bench_scheduler.exe [ticks]
+
+#include "Scheduler.h"
+#include "InstructionsTypes.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Long enough that no process finishes during a run, so every tick executes on every core.
+const int PROGRAM_LENGTH = 1 << 20;
+
+std::shared_ptr<Process> makeProgram() {
+    std::vector<std::shared_ptr<Instruction>> program;
+    program.reserve(PROGRAM_LENGTH);
+    program.push_back(std::make_shared<DeclareInstruction>("x", 1));
+    auto add = std::make_shared<AddInstruction>("x", "x", "1");
+    while (static_cast<int>(program.size()) < PROGRAM_LENGTH) program.push_back(add);
+
+    auto parent = std::make_shared<Process>(0, "bench", PROGRAM_LENGTH);
+    parent->setInstructions(program);
+    return parent;
+}
+
+// Nanoseconds per tick with twice as many processes as cores, so rr always has one to swap in.
+double timeTicks(const std::shared_ptr<Process>& program, int cores, const std::string& algorithm,
+                 bool specialized, int ticks) {
+    Scheduler scheduler(cores, algorithm, 5, 0);
+    scheduler.setFixedCoreEngines(specialized);
+    for (int i = 1; i <= cores * 2; ++i) {
+        scheduler.addProcess(program->fork(i, "p" + std::to_string(i))); // children share the program
+    }
+
+    for (int i = 0; i < ticks / 10; ++i) scheduler.tick(); // warm up
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ticks; ++i) scheduler.tick();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / ticks;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 20000;
+    if (ticks < 10) {
+        std::cerr << "Usage: bench_scheduler [ticks]\n";
+        return 1;
+    }
+
+    auto program = makeProgram();
+    std::cout << ticks << " ticks per run, ns per tick\n";
+    std::cout << std::left << std::setw(6) << "algo" << std::setw(7) << "cores" << std::right
+              << std::setw(13) << "specialized" << std::setw(10) << "generic" << std::setw(10) << "speedup" << "\n";
+    for (const char* algorithm : {"fcfs", "rr"}) {
+        for (int cores : {1, 4, 8, 16, 64}) {
+            double generic = timeTicks(program, cores, algorithm, false, ticks);
+            double specialized = timeTicks(program, cores, algorithm, true, ticks);
+            std::cout << std::left << std::setw(6) << algorithm << std::setw(7) << cores << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(13) << specialized << std::setw(10) << generic
+                      << std::setprecision(2) << std::setw(9) << generic / specialized << "x\n";
+        }
+    }
+    return 0;
+}
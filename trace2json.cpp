@@ -0,0 +1,132 @@
+// trace2json.cpp - converts a trace-start file into Chrome trace JSON
+// (open it in chrome://tracing or ui.perfetto.dev). Each core is a thread row,
+// each stretch a process spends on a core is a slice, sleep and wake are instant events.
+//
+// Compile using: g++ -std=c++17 -o trace2json.exe trace2json.cpp
+// Run using    : trace2json.exe <trace file> <output.json>
+
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const char* eventName(uint8_t event) {
+    switch (static_cast<TraceEvent>(event)) {
+        case TraceEvent::DISPATCH: return "dispatch";
+        case TraceEvent::PREEMPT: return "preempt";
+        case TraceEvent::SLEEP: return "sleep";
+        case TraceEvent::WAKE: return "wake";
+        case TraceEvent::FINISH: return "finish";
+        case TraceEvent::WAIT: return "wait";
+    }
+    return "unknown";
+}
+
+struct OpenSlice {
+    bool open = false;
+    uint32_t pid = 0;
+    uint64_t startTick = 0;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: trace2json <trace file> <output.json>\n";
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open " << argv[1] << "\n";
+        return 1;
+    }
+
+    TraceFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, "CSTR", 4) != 0) {
+        std::cerr << argv[1] << " is not a scheduler trace\n";
+        return 1;
+    }
+    if (header.version != TraceRecorder::VERSION) {
+        std::cerr << "Unsupported trace version " << header.version << "\n";
+        return 1;
+    }
+
+    std::vector<TraceRecord> records;
+    TraceRecord record;
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        records.push_back(record);
+    }
+
+    // buffers are flushed per core, stable sort keeps each core's own order within a tick
+    std::stable_sort(records.begin(), records.end(),
+                     [](const TraceRecord& a, const TraceRecord& b) { return a.tick < b.tick; });
+
+    std::ofstream out(argv[2]);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open " << argv[2] << "\n";
+        return 1;
+    }
+
+    uint64_t us = header.tickMicros ? header.tickMicros : 1;
+    uint16_t maxCore = 0;
+    for (const auto& r : records) maxCore = std::max(maxCore, r.core);
+    size_t coreCount = std::max<size_t>(header.numCores, records.empty() ? 0 : maxCore + 1);
+    uint64_t lastTick = records.empty() ? 0 : records.back().tick;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() -> std::ostream& {
+        if (!first) out << ",\n";
+        first = false;
+        return out;
+    };
+
+    for (size_t core = 0; core < coreCount; ++core) {
+        separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << core
+                    << ",\"args\":{\"name\":\"Core " << core << "\"}}";
+    }
+
+    // a process occupies a core from the tick it is dispatched through the tick it is preempted or finishes
+    std::vector<OpenSlice> slices(coreCount);
+    auto closeSlice = [&](size_t core, uint64_t endTick) {
+        OpenSlice& slice = slices[core];
+        if (!slice.open) return;
+        separator() << "{\"name\":\"p" << slice.pid << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << core
+                    << ",\"ts\":" << slice.startTick * us << ",\"dur\":" << (endTick - slice.startTick + 1) * us
+                    << ",\"args\":{\"pid\":" << slice.pid << "}}";
+        slice.open = false;
+    };
+
+    for (const auto& r : records) {
+        switch (static_cast<TraceEvent>(r.event)) {
+            case TraceEvent::DISPATCH:
+                closeSlice(r.core, r.tick > 0 ? r.tick - 1 : 0);
+                slices[r.core] = {true, r.pid, r.tick};
+                break;
+            case TraceEvent::PREEMPT:
+            case TraceEvent::FINISH:
+            case TraceEvent::WAIT:
+                closeSlice(r.core, r.tick);
+                break;
+            default:
+                break;
+        }
+        // everything but dispatch happens after the tick's instruction ran, so mark it at the end of the tick
+        if (r.event != static_cast<uint8_t>(TraceEvent::DISPATCH)) {
+            separator() << "{\"name\":\"" << eventName(r.event) << "\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" << r.core
+                        << ",\"ts\":" << (r.tick + 1) * us << ",\"args\":{\"pid\":" << r.pid << "}}";
+        }
+    }
+    for (size_t core = 0; core < coreCount; ++core) {
+        closeSlice(core, lastTick);
+    }
+
+    out << "\n]}\n";
+    std::cout << "Wrote " << records.size() << " events to " << argv[2] << "\n";
+    return 0;
+}